@@ -0,0 +1,197 @@
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <random>
+#include <map>
+
+#include "tomus/dictionary.h"
+#include "tomus/tomus.h"
+
+// Benchmarks of the game core, without any window: dictionary loading,
+// admissible lookups, Tomus::Input latency by word length and NewWord cost.
+// Results are printed and written as json to track regressions.
+//
+// Usage: tomus_bench [config.json] [results.json]
+
+using Clock = std::chrono::steady_clock;
+
+struct Stats
+{
+    double mean;
+    double p50;
+    double p99;
+};
+
+Stats Summarize(std::vector<double> samples)
+{
+    if (samples.empty())
+        return {0, 0, 0};
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (const double s : samples)
+        sum += s;
+
+    return {
+        sum / samples.size(),
+        samples[samples.size() / 2],
+        samples[std::min(samples.size() - 1, samples.size() * 99 / 100)]
+    };
+}
+
+template<typename F>
+double Milliseconds(F&& f)
+{
+    const auto start = Clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    using json = nlohmann::json;
+
+    const std::string configPath  = argc > 1 ? argv[1] : "res/config.json";
+    const std::string resultsPath = argc > 2 ? argv[2] : "bench_results.json";
+
+    json results;
+    const auto report = [&](const std::string& name, const Stats& s, const std::string& unit) {
+        results[name] = {{"mean", s.mean}, {"p50", s.p50}, {"p99", s.p99}, {"unit", unit}};
+        std::cout << name << ": mean " << s.mean << ", p50 " << s.p50 << ", p99 " << s.p99 << " " << unit << std::endl;
+    };
+
+    // Dictionary loading
+    std::string dicPath, admPath;
+    Config bounds;
+    {
+        std::ifstream file(configPath);
+        const json data = json::parse(file);
+        bounds.minLength = data["minLength"].get<unsigned int>();
+        bounds.maxLength = data["maxLength"].get<unsigned int>();
+        dicPath = data["mots"].get<std::string>();
+        admPath = data["admissibles"].get<std::string>();
+    }
+
+    const int loadRuns = 5;
+    std::vector<double> textLoad, binaryLoad;
+    Config conf = bounds;
+    for (int i = 0; i < loadRuns; ++i)
+    {
+        Config c = bounds;
+        textLoad.push_back(Milliseconds([&]() { c.LoadText(dicPath, admPath); }));
+        conf = c;
+    }
+    report("load_text", Summarize(textLoad), "ms");
+
+    const std::string imagePath = resultsPath + ".dict";
+    if (SaveDictionary(imagePath, conf))
+    {
+        for (int i = 0; i < loadRuns; ++i)
+        {
+            Config c = bounds;
+            binaryLoad.push_back(Milliseconds([&]() { LoadDictionary(imagePath, c); }));
+        }
+        std::remove(imagePath.c_str());
+        report("load_binary", Summarize(binaryLoad), "ms");
+    }
+
+    const Config full = LoadConfig(configPath);
+    std::mt19937_64 gen(42);
+
+    // Admissible lookups, half hits and half misses
+    {
+        std::vector<std::string> queries;
+        for (uint32_t l = full.minLength; l <= full.maxLength; ++l)
+        {
+            const auto bucket = full.admissibleWords.Bucket(l);
+            for (std::size_t i = 0; i < bucket.size() && i < 50'000; i += 1 + gen() % 4)
+            {
+                std::string w = UnpackWord(bucket[i], l);
+                if (gen() % 2)
+                    w.back() = 'a' + (w.back() - 'a' + 1 + gen() % 25) % 26;
+                queries.push_back(w);
+            }
+        }
+        std::shuffle(queries.begin(), queries.end(), gen);
+
+        std::vector<double> rates;
+        std::size_t found = 0;
+        for (int r = 0; r < 10; ++r)
+        {
+            const double ms = Milliseconds([&]() {
+                for (const auto& q : queries)
+                    found += full.IsWordAdmissible(q);
+            });
+            rates.push_back(queries.size() / (ms * 1e3));
+        }
+        report("is_word_admissible", Summarize(rates), "Mlookups/s");
+        if (found == 0)
+            std::cerr << "Warning, no admissible word found" << std::endl;
+    }
+
+    // Input latency by word length, for guesses sharing the first letter
+    {
+        std::map<uint32_t, std::vector<std::size_t>> wordsByLength;
+        for (std::size_t w = 0; w < full.words.size(); ++w)
+            wordsByLength[full.words[w].size()].push_back(w);
+
+        for (const auto& [length, indices] : wordsByLength)
+        {
+            const auto bucket = full.admissibleWords.Bucket(length);
+            std::vector<double> latencies;
+
+            std::optional<Tomus> tomus;
+            for (std::size_t s = 0; s < 2000; ++s)
+            {
+                // Fresh engine from time to time, to keep the history small
+                if (s % 200 == 0)
+                    tomus.emplace(full);
+
+                const std::size_t idx = indices[gen() % indices.size()];
+                tomus->NewWord(idx);
+
+                const uint64_t first = uint64_t(full.words[idx][0] - 'a') << (kLetterBits * (length - 1));
+                const uint64_t last  = first + (uint64_t(1) << (kLetterBits * (length - 1)));
+                const auto g0 = std::lower_bound(bucket.begin(), bucket.end(), first);
+                const auto g1 = std::lower_bound(bucket.begin(), bucket.end(), last);
+                if (g0 == g1)
+                    continue;
+
+                for (uint32_t t = 0; t < full.maxTries; ++t)
+                {
+                    const std::string guess = UnpackWord(*(g0 + gen() % (g1 - g0)), length);
+
+                    const auto start = Clock::now();
+                    const InputResult r = tomus->Input(guess);
+                    latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+
+                    if (r != InputResult::VALID)
+                        break;
+                }
+            }
+            report("input_" + std::to_string(length), Summarize(latencies), "ns");
+        }
+    }
+
+    // NewWord, after a few tries so that the history grows like in a game
+    {
+        std::vector<double> latencies;
+        Tomus tomus(full);
+        tomus.NewWord();
+        for (std::size_t s = 0; s < 5000; ++s)
+        {
+            const std::string word = tomus.Tries()[0].word.ToString();
+            tomus.Input(word);
+
+            const auto start = Clock::now();
+            tomus.NewWord();
+            latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        }
+        report("new_word", Summarize(latencies), "ns");
+    }
+
+    std::ofstream out(resultsPath);
+    out << results.dump(4) << std::endl;
+    return out ? 0 : 1;
+}
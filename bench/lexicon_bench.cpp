@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <set>
+
+#include "tomus/lexicon.h"
+
+// Compare std::set<std::string> (the previous admissible word storage) with
+// Lexicon, on lookup throughput and resident memory.
+//
+// Usage: tomus_lexicon_bench [words.txt] [minLength] [maxLength]
+
+std::size_t ResidentBytes()
+{
+    // Only available on linux, reports 0 elsewhere
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0, resident = 0;
+    if (statm >> pages >> resident)
+        return resident * 4096;
+    return 0;
+}
+
+template<typename F>
+double MeasureLookups(const std::vector<std::string>& queries, std::size_t rounds, std::size_t& found, F&& lookup)
+{
+    found = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < rounds; ++r)
+        for (const auto& q : queries)
+            found += lookup(q);
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    return (queries.size() * rounds) / seconds;
+}
+
+int main(int argc, char** argv)
+{
+    const std::string path = argc > 1 ? argv[1] : "res/admissible.txt";
+    const uint32_t minLength = argc > 2 ? std::stoi(argv[2]) : 5;
+    const uint32_t maxLength = argc > 3 ? std::stoi(argv[3]) : 9;
+
+    std::vector<std::string> words;
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            std::cerr << "Error, can not load: " << path << std::endl;
+            return 1;
+        }
+
+        std::string buffer;
+        while (std::getline(file, buffer))
+        {
+            if (buffer.size() >= minLength && buffer.size() <= maxLength)
+                words.push_back(buffer);
+        }
+    }
+
+    // Half hits, half misses (last letter changed). Queries are restricted to
+    // a-z as this is all the game lets the player type.
+    std::vector<std::string> typeable;
+    for (const auto& w : words)
+    {
+        if (std::all_of(w.begin(), w.end(), [](char c) { return c >= 'a' && c <= 'z'; }))
+            typeable.push_back(w);
+    }
+
+    std::mt19937 gen(42);
+    std::vector<std::string> queries;
+    for (std::size_t i = 0; i < 1'000'000; ++i)
+    {
+        std::string q = typeable[gen() % typeable.size()];
+        if (i % 2)
+            q.back() = 'a' + (q.back() - 'a' + 1 + gen() % 25) % 26;
+        queries.push_back(q);
+    }
+
+    std::size_t before = ResidentBytes();
+    Lexicon lexicon;
+    auto start = std::chrono::steady_clock::now();
+    lexicon.Insert(words);
+    auto end = std::chrono::steady_clock::now();
+    const std::size_t lexiconRss = ResidentBytes() - before;
+    const double lexiconBuild = std::chrono::duration<double, std::milli>(end - start).count();
+
+    before = ResidentBytes();
+    start = std::chrono::steady_clock::now();
+    std::set<std::string> set(words.begin(), words.end());
+    end = std::chrono::steady_clock::now();
+    const std::size_t setRss = ResidentBytes() - before;
+    const double setBuild = std::chrono::duration<double, std::milli>(end - start).count();
+
+    const std::size_t rounds = 5;
+    std::size_t setFound, lexiconFound;
+    const double setRate = MeasureLookups(queries, rounds, setFound, [&](const std::string& q) {
+        return set.find(q) != set.end();
+    });
+    const double lexiconRate = MeasureLookups(queries, rounds, lexiconFound, [&](const std::string& q) {
+        return lexicon.Contains(q);
+    });
+
+    std::cout << "Words: " << words.size() << " (" << lexicon.Size() << " unique)" << std::endl;
+    std::cout << "std::set: build " << setBuild << " ms, "
+              << setRss / 1024 << " KiB resident, "
+              << setRate / 1e6 << " M lookups/s" << std::endl;
+    std::cout << "Lexicon : build " << lexiconBuild << " ms, "
+              << lexiconRss / 1024 << " KiB resident (" << lexicon.MemoryUsage() / 1024 << " KiB payload), "
+              << lexiconRate / 1e6 << " M lookups/s" << std::endl;
+
+    if (setFound != lexiconFound)
+    {
+        std::cerr << "Error, lookup results differ: " << setFound << " vs " << lexiconFound << std::endl;
+        return 1;
+    }
+    return 0;
+}
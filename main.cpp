@@ -1,7 +1,18 @@
+#include <algorithm>
 #include <format> 
-#include <nlohmann/json.hpp>
+#include <cmath>
 #include "raylib.h"
 #include "tomus/tomus.h"
+#include "tomus/absurd.h"
+#include "tomus/battle.h"
+#include "tomus/solver.h"
+#include "tomus/candidates.h"
+#include "tomus/daily.h"
+#include "tomus/decision.h"
+#include "tomus/difficulty.h"
+#include "tomus/profile.h"
+#include "tomus/leaderboard.h"
+#include "tomus/worker.h"
 
 std::string exeDir = "";
 
@@ -11,6 +22,200 @@ float GetSpacing(float fontSize)
     return 1;
 }
 
+// Font size of each glyph so that it fits a target box. Measuring glyphs is
+// too slow to do per cell and per frame, sizes are computed again only when
+// the box or the font changes.
+struct GlyphSizes
+{
+    void Update(const Font& font, float targetWidth, float targetHeight)
+    {
+        if (font.texture.id == fontId && font.baseSize == baseSize 
+            && targetWidth == width && targetHeight == height)
+            return;
+
+        fontId = font.texture.id;
+        baseSize = font.baseSize;
+        width = targetWidth;
+        height = targetHeight;
+        for (int c = 0; c < (int)sizes.size(); ++c)
+        {
+            GlyphInfo g = GetGlyphInfo(font, c);
+            float w = g.advanceX;
+            float h = font.baseSize + g.offsetY;
+
+            sizes[c] = font.baseSize * std::min(targetWidth / w, targetHeight / h);
+        }
+    }
+
+    float operator[](char letter) const
+    {
+        return sizes[(unsigned char)letter & 0x7F];
+    }
+private:
+    std::array<float, 128> sizes = {};
+    unsigned int fontId = 0;
+    int baseSize = 0;
+    float width = -1.f;
+    float height = -1.f;
+};
+
+enum class FontRole
+{
+    BOARD = 0,
+    HISTORY,
+    LETTERS,
+    INFO,
+    END,
+    COUNT
+};
+
+// The game font baked once per part of the screen, at the pixel size it is
+// drawn at, rather than one default size font scaled by every DrawTextEx.
+// Board fonts only hold uppercase letters, digits and '.', text fonts the
+// printable ASCII range. A new size is baked only after it has been asked
+// for during kDebounce seconds, so that dragging the window does not bake
+// every frame, and there is never more than one atlas per role.
+struct FontManager
+{
+    static constexpr double kDebounce = 0.25;
+    static constexpr int kSizeStep = 4;   // Sizes are rounded up to this many pixels
+    static constexpr int kMaxSize  = 160; // Bounds the atlas memory
+
+    void Load(const std::string& fontPath)
+    {
+        path = fontPath;
+        reference = LoadFont(path.c_str());
+    }
+
+    // Pixel size fitting every glyph the role draws in the target box. Called
+    // every frame: glyphs are only measured again when the box changes.
+    void Request(FontRole role, float targetWidth, float targetHeight, double now)
+    {
+        Atlas& atlas = atlases[(int)role];
+        if (targetWidth == atlas.targetWidth && targetHeight == atlas.targetHeight)
+            return;
+        atlas.targetWidth = targetWidth;
+        atlas.targetHeight = targetHeight;
+
+        float size = 0.f;
+        for (const int c : Codepoints(role, true))
+        {
+            GlyphInfo g = GetGlyphInfo(reference, c);
+            float w = g.advanceX;
+            float h = reference.baseSize + g.offsetY;
+            size = std::max(size, reference.baseSize * std::min(targetWidth / w, targetHeight / h));
+        }
+
+        const int pixels = std::clamp(((int)std::ceil(size) + kSizeStep - 1) / kSizeStep * kSizeStep, kSizeStep, kMaxSize);
+        if (pixels != atlas.wanted)
+        {
+            atlas.wanted = pixels;
+            atlas.since = now;
+        }
+    }
+
+    // Bakes the sizes requested long enough, true when a font changed
+    bool Update(double now)
+    {
+        bool changed = false;
+        for (int r = 0; r < (int)FontRole::COUNT; ++r)
+        {
+            Atlas& atlas = atlases[r];
+            if (atlas.wanted == atlas.size)
+                continue;
+            // The first bake does not wait
+            if (atlas.size != 0 && now - atlas.since < kDebounce)
+                continue;
+
+            std::vector<int> codepoints = Codepoints((FontRole)r, false);
+            Font font = LoadFontEx(path.c_str(), atlas.wanted, codepoints.data(), codepoints.size());
+            atlas.size = atlas.wanted; // Not retried when baking fails
+            if (font.texture.id == 0)
+                continue;
+
+            SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+            if (atlas.font.texture.id != 0)
+                UnloadFont(atlas.font);
+            atlas.font = font;
+            changed = true;
+        }
+
+        if (changed)
+            generation++;
+        return changed;
+    }
+
+    const Font& Get(FontRole role) const
+    {
+        const Atlas& atlas = atlases[(int)role];
+        return atlas.font.texture.id != 0 ? atlas.font : reference;
+    }
+
+    // Changes whenever an atlas is baked again
+    unsigned int Generation() const
+    {
+        return generation;
+    }
+
+    // Bytes of the baked atlases (gray + alpha)
+    std::size_t MemoryUsage() const
+    {
+        std::size_t bytes = 0;
+        for (const Atlas& atlas : atlases)
+            bytes += (std::size_t)atlas.font.texture.width * atlas.font.texture.height * 2;
+        return bytes;
+    }
+
+    void Unload()
+    {
+        for (Atlas& atlas : atlases)
+        {
+            if (atlas.font.texture.id != 0)
+                UnloadFont(atlas.font);
+            atlas = {};
+        }
+        UnloadFont(reference);
+    }
+private:
+    struct Atlas
+    {
+        Font font = {};
+        int size = 0;
+        int wanted = 0;
+        double since = 0.0;
+        float targetWidth = -1.f;   // Box wanted was measured for
+        float targetHeight = -1.f;
+    };
+
+    // Glyphs baked for a role, or only those that decide its size
+    static std::vector<int> Codepoints(FontRole role, bool sizing)
+    {
+        std::vector<int> codepoints;
+        if (role == FontRole::INFO || role == FontRole::END)
+        {
+            if (sizing)
+                return {'M'}; // See DrawInfo and DrawEndScreen
+            for (int c = 32; c < 127; ++c)
+                codepoints.push_back(c);
+            return codepoints;
+        }
+
+        for (int c = 'A'; c <= 'Z'; ++c)
+            codepoints.push_back(c);
+        if (role != FontRole::LETTERS)
+            codepoints.push_back('.');
+        if (!sizing)
+            for (int c = '0'; c <= '9'; ++c)
+                codepoints.push_back(c);
+        return codepoints;
+    }
+
+    std::string path;
+    Font reference = {};
+    std::array<Atlas, (int)FontRole::COUNT> atlases;
+    unsigned int generation = 0;
+};
+
 struct DrawBoardConfig
 {
     Vector2 topLeft;
@@ -31,16 +236,19 @@ struct DrawBoardConfig
     Color goodColor   = {239, 73, 73, 255};
     Color inwordColor = {247, 185, 89, 255};
 
+    GlyphSizes glyphSizes;
+
     DrawBoardConfig()
     { }
 
-    float GetFontSize(char letter) const
+    void UpdateGlyphs()
     {
-        GlyphInfo g = GetGlyphInfo(font, letter);
-        float w = g.advanceX;
-        float h = font.baseSize + g.offsetY;
+        glyphSizes.Update(font, fontTargetSize, fontTargetSize);
+    }
 
-        return font.baseSize * std::min(fontTargetSize / w, fontTargetSize / h);
+    float GetFontSize(char letter) const
+    {
+        return glyphSizes[letter];
     }
 };
 
@@ -63,16 +271,19 @@ struct DrawLetterConfig
     Color goodColor   = {239, 73, 73, 255};
     Color inwordColor = {247, 185, 89, 255};
 
+    GlyphSizes glyphSizes;
+
     DrawLetterConfig() 
     {}
 
-    float GetFontSize(char letter) const
+    void UpdateGlyphs()
     {
-        GlyphInfo g = GetGlyphInfo(font, letter);
-        float w = g.advanceX;
-        float h = font.baseSize + g.offsetY;
+        glyphSizes.Update(font, size.x, size.y);
+    }
 
-        return font.baseSize * std::min(size.x / w, size.y / h);
+    float GetFontSize(char letter) const
+    {
+        return glyphSizes[letter];
     }
 };
 
@@ -86,13 +297,16 @@ struct DrawInfoConfig
     Vector2 wordPos;
     Vector2 errorPos;
 
-    float GetFontSize(char letter) const
+    GlyphSizes glyphSizes;
+
+    void UpdateGlyphs()
     {
-        GlyphInfo g = GetGlyphInfo(font, letter);
-        float w = g.advanceX;
-        float h = font.baseSize + g.offsetY;
+        glyphSizes.Update(font, letterSize, letterSize);
+    }
 
-        return font.baseSize * std::min(letterSize / w, letterSize / h);
+    float GetFontSize(char letter) const
+    {
+        return glyphSizes[letter];
     }
 };
 
@@ -104,13 +318,16 @@ struct DrawEndConfig
 
     Vector2 stringPos;
 
-    float GetFontSize(char letter) const
+    GlyphSizes glyphSizes;
+
+    void UpdateGlyphs()
     {
-        GlyphInfo g = GetGlyphInfo(font, letter);
-        float w = g.advanceX;
-        float h = font.baseSize + g.offsetY;
+        glyphSizes.Update(font, letterSize, letterSize);
+    }
 
-        return font.baseSize * std::min(letterSize / w, letterSize / h);
+    float GetFontSize(char letter) const
+    {
+        return glyphSizes[letter];
     }};
 
 struct DrawTomusConfig
@@ -140,20 +357,28 @@ struct DrawTomusConfig
     DrawLetterConfig letters;
     DrawEndConfig end;
 
-    void SetFont(Font f)
+    void SetFonts(const FontManager& fonts)
+    {
+        board.font = fonts.Get(FontRole::BOARD);
+        history.font = fonts.Get(FontRole::HISTORY);
+        info.font = fonts.Get(FontRole::INFO);
+        letters.font = fonts.Get(FontRole::LETTERS);
+        end.font = fonts.Get(FontRole::END);
+    }
+
+    void RequestFonts(FontManager& fonts, double now) const
     {
-        board.font = f;
-        history.font = f;
-        info.font = f;
-        letters.font = f;
-        end.font = f;
+        fonts.Request(FontRole::BOARD, board.fontTargetSize, board.fontTargetSize, now);
+        fonts.Request(FontRole::HISTORY, history.fontTargetSize, history.fontTargetSize, now);
+        fonts.Request(FontRole::LETTERS, letters.size.x, letters.size.y, now);
+        fonts.Request(FontRole::INFO, info.letterSize, info.letterSize, now);
+        fonts.Request(FontRole::END, end.letterSize, end.letterSize, now);
     }
 
-    void Update(int width, int height, const Tomus& tomus)
+    void Update(int width, int height, const Config& config, unsigned int wordSize)
     {
-        const unsigned int maxWord = tomus.config.maxLength;
-        const unsigned int wordSize = tomus.Tries()[0].word.size();
-        const unsigned int tries = tomus.config.maxTries;
+        const unsigned int maxWord = config.maxLength;
+        const unsigned int tries = config.maxTries;
         const unsigned int letterRowCount = 10;
 
         int dim = std::min(width, height);
@@ -199,17 +424,19 @@ struct DrawTomusConfig
 
         end.letterSize = info.letterSize * 2;
         end.stringPos  = info.wordPos;
+
+        board.UpdateGlyphs();
+        history.UpdateGlyphs();
+        letters.UpdateGlyphs();
+        info.UpdateGlyphs();
+        end.UpdateGlyphs();
     }
 };
 
-void DrawBoard(
-    const DrawBoardConfig& config, 
-    const std::vector<Try> tries, 
-    const unsigned int maxTries, 
-    const std::string& currentInput, 
-    bool withGrid, bool withInput
-)
+// Rows of the tries already played
+void DrawBoardRows(const DrawBoardConfig& config, std::span<const Try> tries)
 {
+    TOMUS_PROFILE_SCOPE("DrawBoardRows");
     const char majShift = 'A' - 'a';
     const auto computePosX = [&](int idx, bool spacing = false) {
         return config.topLeft.x + idx * config.gridSize + spacing * config.fontSpacing.x;
@@ -247,98 +474,135 @@ void DrawBoard(
             DrawTextEx(config.font, buff, Vector2{x, y}, fsize, spacing, config.fontColor);
         }
     }
+}
 
-    if (withInput && tries.size() <= maxTries)
+// Row being typed, with the cursor
+void DrawBoardInput(const DrawBoardConfig& config, std::span<const Try> tries, const std::string& currentInput)
+{
+    TOMUS_PROFILE_SCOPE("DrawBoardInput");
+    const char majShift = 'A' - 'a';
+    const auto computePosX = [&](int idx, bool spacing = false) {
+        return config.topLeft.x + idx * config.gridSize + spacing * config.fontSpacing.x;
+    };
+    const auto computePosY = [&](int idx, bool spacing = false) {
+        return config.topLeft.y + idx * config.gridSize - spacing * config.fontSpacing.y;
+    };
+
+    const auto& lastTry = tries.back();
+    const float y = computePosY(tries.size() - 1, true);
+    const char buffEmpty[2] = {config.emptyLetter, '\0'};
+
+    // Draw cursor 
+    unsigned int pos = currentInput.size();
     {
-        const auto& lastTry = tries.back();
-        const float y = computePosY(tries.size() - 1, true);
-        const char buffEmpty[2] = {config.emptyLetter, '\0'};
+        if (currentInput.size() > 0) pos --;
+
+        const float x = computePosX(pos);
+
+        Rectangle rect = {
+            .x = computePosX(pos) + config.gridThickness / 2, 
+            .y = computePosY(tries.size() - 1) + config.gridThickness / 2,
+            .width  = config.gridSize,
+            .height = config.gridSize
+        };
+        DrawRectangleRec(rect, config.cursorColor);
+    }
 
-        // Draw cursor 
-        unsigned int pos = currentInput.size();
-        {
-            if (currentInput.size() > 0) pos --;
 
-            const float x = computePosX(pos);
+    for (unsigned int j = 0; j < lastTry.word.size(); ++j)
+    {
+        const float x = computePosX(j, true);
 
+        if (j < currentInput.size())
+        {
             Rectangle rect = {
-                .x = computePosX(pos) + config.gridThickness / 2, 
+                .x = computePosX(j) + config.gridThickness / 2, 
                 .y = computePosY(tries.size() - 1) + config.gridThickness / 2,
                 .width  = config.gridSize,
                 .height = config.gridSize
             };
             DrawRectangleRec(rect, config.cursorColor);
         }
+        if (j < currentInput.size() && j != 0)
+        {
+            const char buff[2] = {(char)(currentInput[j] + majShift), '\0'};
 
-
-        for (unsigned int j = 0; j < lastTry.word.size(); ++j)
+            auto fsize = config.GetFontSize(buff[0]);
+            auto spacing = GetSpacing(fsize);
+            DrawTextEx(config.font, buff, Vector2{x, y}, fsize, spacing, config.fontColor);
+        }
+        else
         {
-            const float x = computePosX(j, true);
-            
-            if (j < currentInput.size())
-            {
-                Rectangle rect = {
-                    .x = computePosX(j) + config.gridThickness / 2, 
-                    .y = computePosY(tries.size() - 1) + config.gridThickness / 2,
-                    .width  = config.gridSize,
-                    .height = config.gridSize
-                };
-                DrawRectangleRec(rect, config.cursorColor);
-            }
-            if (j < currentInput.size() && j != 0)
+            if (lastTry.bestStates[j] == State::GOOD_POSITION)
             {
-                const char buff[2] = {(char)(currentInput[j] + majShift), '\0'};
-                
+                const char buff[2] = {(char)(lastTry.word[j] + majShift), '\0'};
                 auto fsize = config.GetFontSize(buff[0]);
                 auto spacing = GetSpacing(fsize);
                 DrawTextEx(config.font, buff, Vector2{x, y}, fsize, spacing, config.fontColor);
             }
             else
             {
-                if (lastTry.bestStates[j] == State::GOOD_POSITION)
-                {
-                    const char buff[2] = {(char)(lastTry.word[j] + majShift), '\0'};
-                    auto fsize = config.GetFontSize(buff[0]);
-                    auto spacing = GetSpacing(fsize);
-                    DrawTextEx(config.font, buff, Vector2{x, y}, fsize, spacing, config.fontColor);
-                }
-                else
-                {
-                    auto fsize = config.GetFontSize(buffEmpty[0]);
-                    auto spacing = GetSpacing(fsize);
-                    DrawTextEx(config.font, buffEmpty, Vector2{x, y}, fsize, spacing, config.fontColor);
-                }
+                auto fsize = config.GetFontSize(buffEmpty[0]);
+                auto spacing = GetSpacing(fsize);
+                DrawTextEx(config.font, buffEmpty, Vector2{x, y}, fsize, spacing, config.fontColor);
             }
         }
     }
+}
 
-    if (withGrid)
+void DrawBoardGrid(const DrawBoardConfig& config, unsigned int length, unsigned int firstRow, unsigned int lastRow)
+{
+    TOMUS_PROFILE_SCOPE("DrawBoardGrid");
+    const auto computePosX = [&](int idx) {
+        return config.topLeft.x + idx * config.gridSize;
+    };
+    const auto computePosY = [&](int idx) {
+        return config.topLeft.y + idx * config.gridSize;
+    };
+
+    // TODO: Thickness is not correct on edges
+    for (unsigned int i = firstRow; i < lastRow; ++i)
     {
-        // TODO: Thickness is not correct on edges
-        for (unsigned int i = 0; i < maxTries; ++i)
+        const float y = computePosY(i);
+        for (unsigned int j = 0; j < length; ++j)
         {
-            const float y = computePosY(i);
-            for (unsigned int j = 0; j < tries[0].word.size(); ++j)
-            {
-                const float x = computePosX(j);
-
-                Rectangle rect = {
-                    .x = x, .y = y,
-                    .width = config.gridSize, 
-                    .height = config.gridSize
-                };
-                DrawRectangleLinesEx(rect, config.gridThickness, config.gridColor);
-            }
+            const float x = computePosX(j);
+
+            Rectangle rect = {
+                .x = x, .y = y,
+                .width = config.gridSize, 
+                .height = config.gridSize
+            };
+            DrawRectangleLinesEx(rect, config.gridThickness, config.gridColor);
         }
     }
 }
 
+void DrawBoard(
+    const DrawBoardConfig& config, 
+    std::span<const Try> tries, 
+    const unsigned int maxTries, 
+    const std::string& currentInput, 
+    bool withGrid, bool withInput
+)
+{
+    TOMUS_PROFILE_SCOPE("DrawBoard");
+    DrawBoardRows(config, tries);
+
+    if (withInput && tries.size() <= maxTries)
+        DrawBoardInput(config, tries, currentInput);
+
+    if (withGrid)
+        DrawBoardGrid(config, tries[0].word.size(), 0, maxTries);
+}
+
 void DrawHistory(
         const DrawBoardConfig& conf, 
-        const std::vector<std::vector<Try>>& history,
+        const TryHistory& history,
         int maxH = 3
 )
 {
+    TOMUS_PROFILE_SCOPE("DrawHistory");
     if (history.size() == 0) return;
     
     unsigned int start = std::max((int)history.size() - (int)maxH, 0);
@@ -354,6 +618,7 @@ void DrawHistory(
 
 void DrawLetter(const DrawLetterConfig& conf, char letter, Vector2 pos, State s)
 {
+    TOMUS_PROFILE_SCOPE("DrawLetter");
     const char majShift = 'A' - 'a';
     Color fontColor = conf.defaultColor;
     if (s == State::NOT_IN_WORD) fontColor = conf.notinwordColor;
@@ -381,8 +646,9 @@ void DrawLetter(const DrawLetterConfig& conf, char letter, Vector2 pos, State s)
 
 void DrawLetters(
     const DrawLetterConfig& conf,
-    const std::array<State, 26>& states)
+    const PackedStates& states)
 {
+    TOMUS_PROFILE_SCOPE("DrawLetters");
     static const std::array<std::string, 3> layout = {
         "azertyuiop", 
         "qsdfghjklm", 
@@ -401,14 +667,18 @@ void DrawLetters(
     }
 }
 
+// candidates: solution words still possible, shown when not negative
 void DrawInfo(const DrawInfoConfig& conf, 
     int wCount, int score, int time,
-    const std::string& err
+    const std::string& err,
+    long candidates = -1
 )
 {
+    TOMUS_PROFILE_SCOPE("DrawInfo");
     const int m = time / 60;
     const int s = time % 60;
-    const std::string wMsg = std::format("Mot: {}", wCount);
+    const std::string wMsg = candidates >= 0 ? std::format("Mot: {} ({} possibles)", wCount, candidates) 
+                                             : std::format("Mot: {}", wCount);
     const std::string sMsg = std::format("Score: {}", score);
     const std::string tMsg = std::format("Timer: {:02}m{:02}", time / 60, time % 60);
     const std::string eMsg = err;
@@ -434,121 +704,102 @@ void DrawInfo(const DrawInfoConfig& conf,
     DrawTextEx(conf.font, eMsg.c_str(), Vector2{eX, eY}, fSize, spacing, conf.fontColor);
 }
 
-Config LoadConfig(const std::string& path)
-{
-    using json = nlohmann::json;
+#include <ctime>
 
-    Config conf;
-    std::ifstream file(path);
-    try
-    {
-        if (file)
+// leaderboard.log/.idx next to the executable, the former leaderboard.json
+// is imported when the log is first created. Only used from the I/O worker,
+// see LeaderboardView.
+Leaderboard& GameLeaderboard()
+{
+    static Leaderboard board;
+    static bool opened = [&]() {
+        const std::string base = exeDir + "/leaderboard";
+        const bool fresh = !std::filesystem::exists(base + ".log");
+        if (!board.Open(base))
         {
-            json data = json::parse(file);
-
-            conf.minLength = data["minLength"].get<unsigned int>();
-            conf.maxLength = data["maxLength"].get<unsigned int>();
-            conf.maxTries  = data["maxTries"].get<unsigned int>();
-            conf.maxTime   = data["maxTime"].get<unsigned int>();
-            
-            const std::string dicPath = data["mots"].get<std::string>();
-            const std::string admPath = data["admissibles"].get<std::string>();
-
-            std::ifstream fDic(dicPath);
-            std::ifstream aDic(admPath);
-            if (fDic && aDic)
-            {
-                std::string buffer;
-                std::vector<std::string> words;
-                while (std::getline(fDic, buffer))
-                {
-                    if (buffer.size() > conf.minLength && buffer.size() < conf.maxLength)
-                        words.push_back(buffer);
-                }
-                conf.SetWords(words);
-                std::cout << "Loaded: " << words.size() << std::endl;
+            std::cerr << "Error, can not open leaderboard: " << base << ".log" << std::endl;
+            return false;
+        }
+        if (fresh && std::filesystem::exists(exeDir + "/leaderboard.json"))
+            board.ImportJson(exeDir + "/leaderboard.json");
+        return true;
+    }();
+    (void)opened;
+    return board;
+}
 
-                words.resize(0);
-                while (std::getline(aDic, buffer))
-                {
-                    if (buffer.size() >= conf.minLength && buffer.size() <= conf.maxLength)
-                        words.push_back(buffer);
-                }
-                conf.SetAdmissible(words);
-                std::cout << "Loaded: " << words.size() << std::endl;
+// What the game loop knows of the leaderboard. Reads and saves are queued on
+// the I/O worker, in order, and their results come back through Poll. Daily
+// runs only rank against the same puzzle.
+struct LeaderboardView
+{
+    using Result = std::pair<bool, std::vector<LeaderboardSummary>>;
 
-                return conf;
-            }
-            else
-            {
-                std::cerr << "Errro, can not load dictionnary: " << dicPath << std::endl;
-                exit(1);
-            }
-        }
-        else
-        {
-            std::cerr << "Error, can not load [no file]: " << path << std::endl;
-            exit(1);
-        }
-    }
-    catch(std::exception& ex)
+    void Load(IoWorker& io)
     {
-        std::cerr << "Error, can not load: " << path << "; error = " << ex.what() << std::endl;
-        exit(1);
+        io.Submit<Result>(
+            [period = period]() { return Result{true, GameLeaderboard().Top(3, period)}; },
+            [this](Result r, const std::string& e) {
+                top = std::move(r.second);
+                if (!e.empty())
+                    std::cerr << e << std::endl;
+            });
     }
-    return conf;
-}
 
-struct Entry 
-{
-    std::string team;
-    int score;
-    int wordCount;
-    int time;
-    int day;
-    int month;
-    int year;
-    std::vector<std::vector<std::string>> guesses;
-
-    bool operator<(const Entry& other) {
-        // So that sort returns top to bottom
-        return score > other.score;
+    void Save(IoWorker& io, LeaderboardEntry entry)
+    {
+        saving = true;
+        entry.puzzle = period.puzzle;
+        io.Submit<Result>(
+            [entry = std::move(entry), period = period]() {
+                const bool saved = GameLeaderboard().Insert(entry);
+                return Result{saved, GameLeaderboard().Top(3, period)};
+            },
+            [this](Result r, const std::string& e) {
+                saving = false;
+                top = std::move(r.second);
+                if (!e.empty())
+                    std::cerr << e << std::endl;
+                if (!r.first)
+                    error = "Erreur, score non enregistre";
+            });
     }
+
+    LeaderboardPeriod period;
+    std::vector<LeaderboardSummary> top;
+    bool saving = false;
+    std::string error;
 };
 
-#include <ctime>
+// Decision trees by word length, empty when tomus_decision did not build them
+using DecisionTrees = std::array<DecisionTree, kMaxFeedbackLength + 1>;
 
-void DrawEndScreen(const DrawEndConfig& conf, const std::string& display, const std::string& in, bool isWin, int score, int ttime, int wordCount, const Tomus& tomus)
+// The guesses of a word against the optimal line of its tree: how many were
+// played, how many the tree plays too, and the tree's own guesses
+std::string ReviewText(const DecisionTrees& trees, std::span<const Try> tries)
 {
-    using json = nlohmann::json;
-    static const std::string leaderBoard = exeDir + "/leaderboard.json";
-    static json data;
-    static bool saved = false;
-    static std::vector<Entry> entries = [&]() {
-        std::vector<Entry> entries;
-
-        std::ifstream file(leaderBoard.c_str());
-        if (file)
-        {
-            file >> data;
-            for (auto entry : data)
-            {
-                Entry e;
-                e.team = entry["name"].get<std::string>();
-                e.wordCount = entry["score"].get<int>();
-                e.score = entry["wordCount"].get<int>();
-                e.time = entry["time"].get<int>();
-                e.day = entry["day"].get<int>();
-                e.month = entry["month"].get<int>();
-                e.year = entry["year"].get<int>();
-                entries.push_back(e);
-            }
-
-            std::sort(entries.begin(), entries.end());
-        }
-        return entries;
-    }();
+    DecisionReview review;
+    const std::size_t length = tries.empty() ? 0 : tries[0].word.size();
+    if (length >= trees.size() || !trees[length].Review(tries, review))
+        return "";
+
+    const uint64_t answer = tries[0].word.Code();
+    const bool won = tries.size() > 1 && tries.back().input.Code() == answer;
+    const bool optimalWon = review.line.back() == answer;
+    std::string line;
+    for (const uint64_t guess : review.line)
+        line += (line.empty() ? "" : " ") + UnpackWord(guess, length);
+
+    return std::format("{}: {} ({} comme l'optimal) - optimal {}: {}", UnpackWord(answer, length),
+        won ? std::format("{} coups", tries.size() - 1) : "perdu", review.followed,
+        optimalWon ? std::format("{} coups", review.line.size()) : "perdu", line);
+}
 
+void DrawEndScreen(const DrawEndConfig& conf, const std::string& display, const std::string& in, bool isWin, int score, int ttime, int wordCount, const Tomus& tomus, const DecisionTrees& trees, LeaderboardView& board, IoWorker& io)
+{
+    TOMUS_PROFILE_SCOPE("DrawEndScreen");
+    static bool saved = false;
+    const auto& entries = board.top;
 
     int fSize = conf.GetFontSize('M'); // Biggest letter I guess
     int spacing = GetSpacing(fSize);
@@ -573,12 +824,40 @@ void DrawEndScreen(const DrawEndConfig& conf, const std::string& display, const
     for (unsigned int i = 0; i < std::min((int)entries.size(), 3); ++i)
     {
         const auto& e = entries[i];
-        std::string txt = std::format("{}/{}/{} - {} - {} en {} mots", e.day, e.month, e.year, e.team, e.score, e.wordCount);
+        std::string txt = std::format("{}/{}/{} - {} - {} en {} mots", (int)e.day, (int)e.month, (int)e.year, e.name, e.score, e.wordCount);
         Vector2 S = MeasureTextEx(conf.font, txt.c_str(), fSize, spacing);
         iPos = { conf.stringPos.x - S.x / 2, iPos.y + (int)(1.1 * S.y)};
         DrawTextEx(conf.font, txt.c_str(), iPos, fSize, spacing, conf.fontColor);
     }
 
+    if (!board.error.empty())
+    {
+        Vector2 S = MeasureTextEx(conf.font, board.error.c_str(), fSize, spacing);
+        iPos = { conf.stringPos.x - S.x / 2, iPos.y + (int)(1.1 * S.y)};
+        DrawTextEx(conf.font, board.error.c_str(), iPos, fSize, spacing, conf.fontColor);
+    }
+
+    // The last three words played against the optimal trees, the one just
+    // played first. Words holding only their initial try were drawn after
+    // the game ended (a win past maxTime, the last daily puzzle).
+    const float rSize = fSize / 2.f;
+    std::size_t reviewed = 0;
+    const auto review = [&](std::span<const Try> tries) {
+        if (tries.size() < 2 || reviewed == 3)
+            return;
+        const std::string txt = ReviewText(trees, tries);
+        if (txt.empty())
+            return;
+        Vector2 S = MeasureTextEx(conf.font, txt.c_str(), rSize, GetSpacing(rSize));
+        iPos = { conf.stringPos.x - S.x / 2, iPos.y + (int)(1.1 * S.y)};
+        DrawTextEx(conf.font, txt.c_str(), iPos, rSize, GetSpacing(rSize), conf.fontColor);
+        reviewed++;
+    };
+    review(tomus.Tries());
+    const TryHistory& history = tomus.History();
+    for (std::size_t i = history.size(); i > 0 && reviewed < 3; --i)
+        review(history[i - 1]);
+
     if (IsKeyPressed(KEY_ENTER) && isWin)
     {
         if (!saved && in.size() > 0)
@@ -586,43 +865,350 @@ void DrawEndScreen(const DrawEndConfig& conf, const std::string& display, const
             time_t now = time(0);
             struct tm* tm = localtime(&now);
 
-            std::vector<std::vector<std::string>> inputs;
-            for (const auto& entry : tomus.History())
+            LeaderboardEntry entry;
+            entry.name = in;
+            entry.score = score;
+            entry.wordCount = wordCount;
+            entry.time = ttime;
+            entry.day = tm->tm_mday;
+            entry.month = tm->tm_mon + 1;
+            entry.year = 1900 + tm->tm_year;
+            entry.seed = tomus.Seed();
+
+            // The initial try of each game is not a guess
+            for (const auto& game : tomus.History())
             {
-                inputs.push_back({});
-                for (const auto& in : entry)
-                {
-                    inputs.back().push_back(in.input);
-                }
+                entry.guesses.push_back({});
+                for (const auto& t : game.subspan(1))
+                    entry.guesses.back().push_back(t.input.bits);
             }
 
-            data.push_back({
-                {"name", in}, 
-                {"score", score}, 
-                {"time", ttime},
-                {"wordCount", wordCount}, 
-                {"day", tm->tm_mday}, {"month", tm->tm_mon + 1}, {"year", 1900 + tm->tm_year},
-                {"guesses", inputs }
-            });
             saved = true;
-            std::ofstream file(leaderBoard);
-            file << data.dump(4);
+            board.Save(io, std::move(entry));
 
             input = in;
         }
     }
 }
 
-int main(int argc, char** argv)
+// Everything that only changes when a try is played or the window is
+// resized (played rows, grid, keyboard, history), drawn once into a texture
+// and copied to the screen every frame.
+struct StaticLayer
 {
-    exeDir = GetDirectoryPath(argv[0]);
+    // True when the layer is outdated, it must then be drawn again before End
+    bool Begin(int w, int h, std::size_t tries, std::size_t games, bool playing, unsigned int fonts, Color background)
+    {
+        const Key key = {w, h, tries, games, playing, fonts};
+        if ((target.id != 0 && key == current) || w <= 0 || h <= 0) // Minimised
+            return false;
 
-    Config conf;
-    if (argc > 1) conf = LoadConfig(argv[1]);
-    else          conf = LoadConfig(exeDir + "/res/config.json"); 
+        if (target.id == 0 || w != current.width || h != current.height)
+        {
+            if (target.id != 0)
+                UnloadRenderTexture(target);
+            target = LoadRenderTexture(w, h);
+        }
+        current = key;
 
-    Tomus tomus(conf);
-    tomus.NewWord();
+        BeginTextureMode(target);
+        ClearBackground(background);
+        return true;
+    }
+
+    void End()
+    {
+        EndTextureMode();
+    }
+
+    void Draw() const
+    {
+        // Render textures are stored upside down
+        const Rectangle src = {0, 0, (float)current.width, -(float)current.height};
+        DrawTextureRec(target.texture, src, {0, 0}, WHITE);
+    }
+
+    void Unload()
+    {
+        if (target.id != 0)
+            UnloadRenderTexture(target);
+        target = {};
+    }
+private:
+    struct Key
+    {
+        int width = 0;
+        int height = 0;
+        std::size_t tries = 0;
+        std::size_t games = 0;
+        bool playing = false;
+        unsigned int fonts = 0;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    RenderTexture2D target = {};
+    Key current;
+};
+
+// What the screen shows, in event driven mode a frame is only drawn when it
+// changes
+struct SceneKey
+{
+    int width = 0;
+    int height = 0;
+    std::size_t tries = 0;
+    std::size_t games = 0;
+    bool playing = true;
+    unsigned int fonts = 0;
+    int time = 0; // Displayed second
+    bool overlay = false;
+    std::string input;
+    std::string message;
+
+    bool operator==(const SceneKey&) const = default;
+};
+
+// Average time spent updating and drawing a frame, without waiting for the
+// target FPS, over the last second, and CPU use of the process since start.
+// Shown with F3.
+struct FrameTimer
+{
+    FrameTimer() : cpuStart(std::clock()), wallStart(GetTime())
+    {}
+
+    void Start()
+    {
+        start = GetTime();
+    }
+
+    // Process CPU time over wall time, in %, all threads included
+    double CpuUsage() const
+    {
+        const double cpu = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        return 100.0 * cpu / std::max(GetTime() - wallStart, 1e-9);
+    }
+
+    void Stop()
+    {
+        total += GetTime() - start;
+        if (++frames == 60)
+        {
+            average = 1000.0 * total / frames;
+            total = 0.0;
+            frames = 0;
+        }
+    }
+
+    void Draw(int x, int y, Color color, std::size_t fontBytes) const
+    {
+        const std::string txt = std::format("{:.2f} ms / {} fps / cpu {:.1f} % / fonts {} KB", average, GetFPS(), CpuUsage(), fontBytes / 1024);
+        DrawText(txt.c_str(), x, y, 10, color);
+    }
+
+    bool visible = false;
+private:
+    double start = 0.0;
+    double total = 0.0;
+    double average = 0.0;
+    int frames = 0;
+
+    std::clock_t cpuStart;
+    double wallStart;
+};
+
+// Battle boards in a grid over the area of the single board (down to the
+// messages, the keyboard is not shown), each the board geometry scaled down
+// so that they all fit
+void LayoutBattle(const DrawTomusConfig& drawConf, int width, int height, uint32_t boards, uint32_t length, uint32_t rows, std::vector<DrawBoardConfig>& layout)
+{
+    const DrawBoardConfig& base = drawConf.board;
+    const float left = width * drawConf.boardPositionX;
+    const float top = base.topLeft.y;
+    const float gap = drawConf.smallPadding * std::min(width, height);
+    const float areaW = width - left - drawConf.bigPadding * width;
+    const float areaH = drawConf.info.errorPos.y - gap - top;
+    const float cellW = length * (base.gridSize + base.gridThickness);
+    const float cellH = rows * (base.gridSize + base.gridThickness);
+
+    // Number of columns giving the largest boards
+    uint32_t cols = 1;
+    float scale = 0.f;
+    for (uint32_t c = 1; c <= boards; ++c)
+    {
+        const uint32_t lines = (boards + c - 1) / c;
+        const float s = std::min((areaW - gap * (c - 1)) / (c * cellW), (areaH - gap * (lines - 1)) / (lines * cellH));
+        if (s > scale)
+        {
+            scale = s;
+            cols = c;
+        }
+    }
+    scale = std::clamp(scale, 0.1f, 1.f);
+
+    DrawBoardConfig scaled = base;
+    scaled.gridSize *= scale;
+    scaled.fontTargetSize *= scale;
+    scaled.fontSpacing.x *= scale;
+    scaled.fontSpacing.y *= scale;
+    scaled.UpdateGlyphs();
+
+    const float totalW = cols * cellW * scale + gap * (cols - 1);
+    layout.assign(boards, scaled);
+    for (uint32_t b = 0; b < boards; ++b)
+    {
+        layout[b].topLeft.x = left + (areaW - totalW) / 2 + (b % cols) * (cellW * scale + gap);
+        layout[b].topLeft.y = top + (b / cols) * (cellH * scale + gap);
+    }
+}
+
+// Battle mode ("battle" in the config): rounds of several boards played with
+// the same guesses, chained while they are won within the time limit
+int RunBattle(const Config& conf, DrawTomusConfig& drawConf, FontManager& fonts)
+{
+    Battle battle(conf, conf.seed ? *conf.seed : std::random_device{}());
+    if (!battle.NewRound(conf.battle))
+    {
+        std::cerr << "Error, no length and first letter have " << conf.battle << " solution words" << std::endl;
+        return 1;
+    }
+
+    // Rows of each board, rebuilt after each guess for drawing only
+    std::vector<std::vector<Try>> tries;
+    const auto refresh = [&]() {
+        tries.resize(battle.Boards());
+        for (uint32_t b = 0; b < battle.Boards(); ++b)
+            battle.Tries(b, tries[b]);
+    };
+    refresh();
+
+    std::vector<DrawBoardConfig> layout;
+    std::string input;
+    std::string message;
+    unsigned int score = 0;
+    unsigned int rounds = 1;
+    double startTime = -1.0;
+    int freezeTime = 0;
+    bool playing = true;
+
+    while (!WindowShouldClose())
+    {
+        const PackedWord& word = tries[0][0].word;
+        if (playing)
+        {
+            int key = GetCharPressed();
+            while (key > 0)
+            {
+                if (key >= 'a' && key <= 'z')
+                {
+                    if (startTime < 0.0)
+                        startTime = GetTime();
+                    if (input.empty() && key != word[0])
+                        input.push_back(word[0]);
+                    if (input.size() < word.size())
+                        input.push_back(key);
+                }
+                key = GetCharPressed();
+            }
+
+            if (IsKeyPressed(KEY_BACKSPACE) && !input.empty())
+                input.pop_back();
+
+            if (IsKeyPressed(KEY_ENTER) && input.size() == word.size())
+            {
+                const InputResult r = battle.Input(input);
+                if (r == InputResult::UNKNOWN_WORD)
+                    message = "Ce mot n'est pas dans la liste";
+                else if (r == InputResult::VALID || r == InputResult::WIN || r == InputResult::LOSE)
+                {
+                    input.clear();
+                    message.clear();
+                }
+
+                if (r == InputResult::WIN || r == InputResult::LOSE)
+                {
+                    score += battle.Score();
+                    freezeTime = GetTime() - startTime;
+                }
+                if (r == InputResult::WIN && GetTime() - startTime < conf.maxTime)
+                {
+                    battle.NewRound(conf.battle);
+                    rounds++;
+                }
+                else if (r == InputResult::WIN)
+                {
+                    playing = false;
+                    message = std::format("Score: {} en {} manches", score, rounds);
+                }
+                else if (r == InputResult::LOSE)
+                {
+                    playing = false;
+                    message = "Les mots etaient:";
+                    for (uint32_t b = 0; b < battle.Boards(); ++b)
+                        if (!battle.Solved(b))
+                            message += " " + battle.Answer(b);
+                }
+                refresh();
+            }
+        }
+
+        const int time = startTime < 0.0 ? 0 : playing ? (int)(GetTime() - startTime) : freezeTime;
+        const uint32_t length = tries[0][0].word.size();
+
+        drawConf.Update(GetScreenWidth(), GetScreenHeight(), conf, length);
+        drawConf.RequestFonts(fonts, GetTime());
+        if (fonts.Update(GetTime()))
+        {
+            drawConf.SetFonts(fonts);
+            drawConf.Update(GetScreenWidth(), GetScreenHeight(), conf, length);
+        }
+        LayoutBattle(drawConf, GetScreenWidth(), GetScreenHeight(), battle.Boards(), length, battle.MaxTries(), layout);
+
+        BeginDrawing();
+            ClearBackground(drawConf.backgroundColor);
+            for (uint32_t b = 0; b < battle.Boards(); ++b)
+            {
+                DrawBoardRows(layout[b], tries[b]);
+                if (playing && !battle.Solved(b))
+                    DrawBoardInput(layout[b], tries[b], input);
+                DrawBoardGrid(layout[b], length, 0, battle.MaxTries());
+            }
+            DrawInfo(drawConf.info, rounds, score + (playing ? battle.Score() : 0), time, message);
+        {
+            TOMUS_PROFILE_SCOPE("EndDrawing");
+            EndDrawing();
+        }
+    }
+    return 0;
+}
+
+#ifdef TOMUS_PROFILE
+// Scopes taking the most time over the last second, shown with F4. F5 writes
+// the events still held by the profiler as a Chrome trace.
+struct ProfileOverlay
+{
+    static constexpr int kLines = 12;
+
+    void Draw(int x, int y, Color color) const
+    {
+        int line = 0;
+        for (const ProfileStat& s : ProfileStats(1000000000ull))
+        {
+            if (line == kLines)
+                break;
+            const std::string txt = std::format("{:<26} {:6} calls {:9.3f} ms (max {:.3f} ms)", s.name, s.calls, s.totalMs, s.maxMs);
+            DrawText(txt.c_str(), x, y + 12 * line++, 10, color);
+        }
+    }
+
+    bool visible = false;
+};
+#endif
+
+int main(int argc, char** argv)
+{
+    exeDir = GetDirectoryPath(argv[0]);
+    const std::string configPath = argc > 1 ? argv[1] : exeDir + "/res/config.json";
 
     const int screenWidth = 800;
     const int screenHeight = 450;
@@ -632,10 +1218,130 @@ int main(int argc, char** argv)
     InitWindow(screenWidth, screenHeight, "TOMUS");
     SetTargetFPS(currentFps);
     std::string fontPath = exeDir + "/res/arial.ttf";
-    Font mainFont = LoadFont(fontPath.c_str()); 
+    FontManager fonts;
+    fonts.Load(fontPath);
 
     DrawTomusConfig drawConf;
-    drawConf.SetFont(mainFont);
+    drawConf.SetFonts(fonts);
+
+    // Filled by the worker, declared first so that it outlives it
+    Config conf;
+    std::string loadError;
+    bool loading = true;
+    bool loaded = false;
+    LeaderboardView leaderboard;
+
+    WordSampler sampler;
+    DecisionTrees trees;
+
+    // Daily words follow the local calendar
+    DailySchedule daily;
+    const time_t now = time(0);
+    const struct tm today = *localtime(&now);
+    const uint32_t year = 1900 + today.tm_year;
+
+    // The window stays responsive while the lists load (and the daily
+    // schedule is built, the first run of the year)
+    IoWorker io;
+    io.Submit<bool>(
+        [&]() {
+            if (!LoadConfig(configPath, conf, loadError))
+                return false;
+            // Optional, too long to build here. Before the daily schedule,
+            // which takes its puzzle depths from them
+            for (uint32_t l = conf.minLength; l <= std::min(conf.maxLength, kMaxFeedbackLength); ++l)
+                trees[l].Load(std::format("{}/res/tree_{}.bin", exeDir, l), conf, l);
+            if (conf.daily)
+                daily = DailySchedule::LoadOrBuild(std::format("{}/res/daily_{}.bin", exeDir, year), conf, conf.dailySeed, year, trees);
+            if (conf.selection != WordSelection::UNIFORM)
+                sampler = WordSampler(DifficultyTable::LoadOrBuild(conf.difficultyPath, conf), conf);
+            return true;
+        },
+        [&](bool ok, const std::string& error) {
+            loading = false;
+            loaded = ok;
+            if (!error.empty())
+                loadError = error;
+            if (ok && conf.daily)
+            {
+                leaderboard.period.puzzle = DailyPuzzleId(year, today.tm_yday);
+                leaderboard.Load(io);
+            }
+        });
+    leaderboard.Load(io);
+
+    while (!loaded)
+    {
+        if (WindowShouldClose())
+        {
+            CloseWindow();
+            return loading ? 0 : 1;
+        }
+        io.Poll();
+
+        // Errors stay on screen until the window is closed
+        const std::string msg = loading ? "Chargement..." : loadError;
+        const Font& font = fonts.Get(FontRole::INFO);
+        const float fSize = std::min(GetScreenWidth(), GetScreenHeight()) / 20.f;
+        const Vector2 size = MeasureTextEx(font, msg.c_str(), fSize, GetSpacing(fSize));
+        BeginDrawing();
+            ClearBackground(drawConf.backgroundColor);
+            DrawTextEx(font, msg.c_str(), {(GetScreenWidth() - size.x) / 2, (GetScreenHeight() - size.y) / 2}, 
+                fSize, GetSpacing(fSize), drawConf.info.fontColor);
+        EndDrawing();
+    }
+
+    if (conf.battle > 0)
+    {
+        const int result = RunBattle(conf, drawConf, fonts);
+        fonts.Unload();
+        CloseWindow();
+        return result;
+    }
+
+    Tomus tomus(conf);
+    if (conf.selection != WordSelection::UNIFORM)
+        tomus.SetSampler(&sampler);
+
+    // Replayable with tomus_replay, the seed alone gives back the words
+    GameLogWriter log;
+    if (!conf.logDir.empty())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(conf.logDir, ec);
+        const std::string logPath = std::format("{}/{}_{}.tlog", conf.logDir, 
+            std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count(), tomus.Seed());
+        GameLogHeader header{};
+        header.wordCount = conf.words.size();
+        header.seed = tomus.Seed();
+        header.minLength = conf.minLength;
+        header.maxLength = conf.maxLength;
+        header.maxTries = conf.maxTries;
+        if (log.Open(logPath, header))
+            tomus.SetLog(&log);
+        else
+            std::cerr << "Error, can not write game log: " << logPath << std::endl;
+    }
+
+    // Daily runs play the puzzles of the day in order and end after the last,
+    // absurd mode only applies to random words
+    const std::span<const DailyPuzzle> puzzles = conf.daily ? daily.Day(today.tm_yday) : std::span<const DailyPuzzle>();
+    std::size_t played = 0;
+    AbsurdGame absurd(tomus);
+    const auto nextWord = [&]() {
+        if (played < puzzles.size())
+            tomus.NewWord(puzzles[played].word);
+        else if (conf.absurd)
+            absurd.NewWord();
+        else
+            tomus.NewWord();
+        played++;
+    };
+
+    nextWord();
+    Solver solver(tomus.config);
+    CandidateTracker tracker(tomus.config);
+
     std::vector<char> buffer(conf.maxLength + 1, '\0');
     unsigned int buffSize = 0;
 
@@ -645,12 +1351,23 @@ int main(int argc, char** argv)
     double showErrTime = GetTime();
     double freezeTime = 0.;
 
+    StaticLayer staticLayer;
+    FrameTimer frameTimer;
+#ifdef TOMUS_PROFILE
+    ProfileOverlay profileOverlay;
+#endif
+    SceneKey lastScene;
+    bool firstFrame = true;
+
     bool playing = true;
     bool win = false;
     while (!WindowShouldClose()) 
     {
+        frameTimer.Start();
+        const bool completed = io.Poll() > 0;
+
         const auto& tries = tomus.Tries();
-        auto word = tries[0].word;
+        auto word = tries[0].word.ToString();
 
         if (!playing)
         {
@@ -680,7 +1397,7 @@ int main(int argc, char** argv)
                     // Enforce first letter
                     buffer[0] = word[0];
 
-                    auto rslt = tomus.Input(&buffer[0]);
+                    auto rslt = conf.absurd ? absurd.Input(&buffer[0]) : tomus.Input(&buffer[0]);
                     buffer[0] = '\0';
                     buffSize = 0;
                     errorString = "";
@@ -688,10 +1405,12 @@ int main(int argc, char** argv)
                     freezeTime = GetTime() - startTime; 
                     if (rslt == InputResult::WIN)
                     {
-                        tomus.NewWord();
-                        if (GetTime() - startTime >= conf.maxTime)
+                        nextWord();
+                        const bool dailyDone = conf.daily && played > puzzles.size();
+                        if (dailyDone || GetTime() - startTime >= conf.maxTime)
                         {
-                            tomus.NewWord();
+                            if (!dailyDone)
+                                tomus.NewWord();
                             playing = false;
                             win = true;
 
@@ -709,7 +1428,8 @@ int main(int argc, char** argv)
                     }
                     else if (rslt == InputResult::LOSE)
                     {
-                        errorString = std::format("Le mot etait: {}", word);
+                        // Not word, the absurd mode may have swapped the answer on this guess
+                        errorString = std::format("Le mot etait: {}", tomus.Tries()[0].word.ToString());
                         playing = false;
                         buffer[0] = '\0';
                         buffSize = 0;
@@ -763,25 +1483,123 @@ int main(int argc, char** argv)
             }
         }
 
+        // Hint: replace the current input by the solver's guess
+        if (playing && IsKeyPressed(KEY_TAB))
+        {
+            const std::string hint = solver.Hint(tomus.Tries());
+            if (!hint.empty())
+            {
+                if (startTime < 0.0)
+                    startTime = GetTime();
+
+                std::copy(hint.begin(), hint.end(), buffer.begin());
+                buffer[hint.size()] = '\0';
+                buffSize = hint.size();
+            }
+        }
+
+        if (IsKeyPressed(KEY_F3))
+            frameTimer.visible = !frameTimer.visible;
+        bool overlay = frameTimer.visible;
+#ifdef TOMUS_PROFILE
+        if (IsKeyPressed(KEY_F4))
+            profileOverlay.visible = !profileOverlay.visible;
+        if (IsKeyPressed(KEY_F5))
+        {
+            const std::string tracePath = std::format("{}/trace_{}.json", exeDir,
+                std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+            if (ExportChromeTrace(tracePath))
+                std::cout << "Trace written: " << tracePath << std::endl;
+            else
+                std::cerr << "Error, can not write trace: " << tracePath << std::endl;
+        }
+        overlay = overlay || profileOverlay.visible;
+#endif
+
         int time = GetTime() - startTime;
-        drawConf.Update(GetScreenWidth(), GetScreenHeight(), tomus);
+
+        // Training mode: only the tries played since the last frame cost anything
+        long candidates = -1;
+        if (conf.training && playing)
+        {
+            tracker.Update(tries);
+            candidates = tracker.Count();
+        }
+        drawConf.Update(GetScreenWidth(), GetScreenHeight(), tomus.config, tomus.Tries()[0].word.size());
+        drawConf.RequestFonts(fonts, GetTime());
+        if (fonts.Update(GetTime()))
+        {
+            drawConf.SetFonts(fonts);
+            drawConf.Update(GetScreenWidth(), GetScreenHeight(), tomus.config, tomus.Tries()[0].word.size());
+        }
+
+        // Idle: nothing visible changed, no I/O completed and no key is
+        // waiting (the end screen reads ENTER while drawing), poll input
+        // without drawing
+        if (conf.eventDriven)
+        {
+            const SceneKey scene = {
+                GetScreenWidth(), GetScreenHeight(), tries.size(), tomus.History().size(),
+                playing, fonts.Generation(), time, overlay, &buffer[0], errorString
+            };
+            if (!firstFrame && !completed && scene == lastScene && GetKeyPressed() == 0)
+            {
+                PollInputEvents();
+                WaitTime(1.0 / currentFps);
+                continue;
+            }
+            lastScene = scene;
+            firstFrame = false;
+        }
+
+        const unsigned int wordSize = tries[0].word.size();
+        if (staticLayer.Begin(GetScreenWidth(), GetScreenHeight(), tries.size(), tomus.History().size(), playing, fonts.Generation(), drawConf.backgroundColor))
+        {
+            if (playing)
+            {
+                DrawBoardRows(drawConf.board, tries);
+                DrawBoardGrid(drawConf.board, wordSize, 0, tomus.config.maxTries);
+                DrawLetters(drawConf.letters, tries.back().letters);
+            }
+            DrawHistory(drawConf.history, tomus.History());
+            staticLayer.End();
+        }
         
         BeginDrawing();
+            staticLayer.Draw();
             if (playing)
             {
-                DrawBoard(drawConf.board, tries, tomus.config.maxTries, &buffer[0], true, true);
-                DrawLetters(drawConf.letters, tries.back().letters);
-                DrawInfo(drawConf.info, tomus.History().size() + 1, tomus.Score(), time, errorString);
+                // Only the row being typed changes between two tries
+                if (tries.size() <= tomus.config.maxTries)
+                {
+                    DrawBoardInput(drawConf.board, tries, &buffer[0]);
+                    DrawBoardGrid(drawConf.board, wordSize, tries.size() - 1, tries.size());
+                }
+                DrawInfo(drawConf.info, tomus.History().size() + 1, tomus.Score(), time, errorString, candidates);
             }
             else
             {
-                DrawEndScreen(drawConf.end, errorString, &buffer[0], win, tomus.Score(), freezeTime, tomus.History().size(), tomus);
+                DrawEndScreen(drawConf.end, errorString, &buffer[0], win, tomus.Score(), freezeTime, tomus.History().size(), tomus, trees, leaderboard, io);
             }
-            DrawHistory(drawConf.history, tomus.History());
 
-        EndDrawing();
+            frameTimer.Stop();
+            if (frameTimer.visible)
+                frameTimer.Draw(10, GetScreenHeight() - 20, drawConf.info.fontColor, fonts.MemoryUsage());
+#ifdef TOMUS_PROFILE
+            if (profileOverlay.visible)
+                profileOverlay.Draw(10, 10, drawConf.info.fontColor);
+#endif
+        {
+            TOMUS_PROFILE_SCOPE("EndDrawing");
+            EndDrawing();
+        }
     }
 
+    std::cout << "Average CPU use (" << (conf.eventDriven ? "event driven" : "continuous") << "): " 
+              << frameTimer.CpuUsage() << " %" << std::endl;
+
+    staticLayer.Unload();
+    fonts.Unload();
     CloseWindow();
     return 0;
 }
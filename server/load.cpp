@@ -0,0 +1,183 @@
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <mutex>
+
+#include "tomus/config.h"
+#include "tomus/word.h"
+
+// Load generator for tomus_server: opens many sessions over a few connections,
+// then keeps guessing in all of them and reports request latencies. Lost
+// games are recorded in the leaderboard (END with a name) and followed by a
+// TOP read.
+//
+// Usage: tomus_server_load [config.json] [--unix path] [--sessions n] [--connections n] [--rounds n]
+
+struct Client
+{
+    int fd = -1;
+    std::string pending;
+
+    bool Connect(const std::string& path)
+    {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        return fd >= 0 && connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0;
+    }
+
+    std::string Request(const std::string& line)
+    {
+        const std::string msg = line + "\n";
+        if (write(fd, msg.data(), msg.size()) != (ssize_t)msg.size())
+            return "";
+
+        char buffer[4096];
+        while (pending.find('\n') == std::string::npos)
+        {
+            const ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) return "";
+            pending.append(buffer, n);
+        }
+
+        const auto end = pending.find('\n');
+        const std::string reply = pending.substr(0, end);
+        pending.erase(0, end + 1);
+        return reply;
+    }
+};
+
+struct Game
+{
+    std::string id;
+    uint32_t length;
+    char letter;
+};
+
+// Parse "OK <id> <length> <letter>"
+bool ParseNew(const std::string& reply, Game& g)
+{
+    char id[32], letter;
+    unsigned int length;
+    if (std::sscanf(reply.c_str(), "OK %31s %u %c", id, &length, &letter) != 3)
+        return false;
+
+    g = Game{id, length, letter};
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::string configPath = "res/config.json";
+    std::string unixPath = "/tmp/tomus.sock";
+    std::size_t sessions = 10000, connections = 4, rounds = 5;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--unix" && i + 1 < argc)             unixPath = argv[++i];
+        else if (arg == "--sessions" && i + 1 < argc)    sessions = std::stoull(argv[++i]);
+        else if (arg == "--connections" && i + 1 < argc) connections = std::stoull(argv[++i]);
+        else if (arg == "--rounds" && i + 1 < argc)      rounds = std::stoull(argv[++i]);
+        else                                             configPath = arg;
+    }
+
+    const Config conf = LoadConfig(configPath);
+
+    std::mutex mutex;
+    std::vector<double> latencies;
+    std::size_t failures = 0;
+
+    const auto worker = [&](std::size_t w) {
+        Client client;
+        if (!client.Connect(unixPath))
+        {
+            std::lock_guard lock(mutex);
+            std::cerr << "Error, can not connect to: " << unixPath << std::endl;
+            failures++;
+            return;
+        }
+
+        std::mt19937_64 gen(w);
+        std::vector<double> local;
+        std::size_t failed = 0;
+        const auto timed = [&](const std::string& request) {
+            const auto start = std::chrono::steady_clock::now();
+            const std::string reply = client.Request(request);
+            local.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            return reply;
+        };
+
+        std::vector<Game> games;
+        for (std::size_t s = w; s < sessions; s += connections)
+        {
+            Game g;
+            if (ParseNew(timed("NEW"), g)) games.push_back(g);
+            else failed++;
+        }
+
+        for (std::size_t r = 0; r < rounds; ++r)
+        {
+            for (Game& g : games)
+            {
+                // Any admissible word with the right first letter
+                const auto bucket = conf.admissibleWords.Bucket(g.length);
+                const uint64_t first = uint64_t(g.letter - 'a') << (kLetterBits * (g.length - 1));
+                const uint64_t last  = first + (uint64_t(1) << (kLetterBits * (g.length - 1)));
+                const auto g0 = std::lower_bound(bucket.begin(), bucket.end(), first);
+                const auto g1 = std::lower_bound(bucket.begin(), bucket.end(), last);
+                if (g0 == g1)
+                    continue;
+
+                const std::string guess = UnpackWord(*(g0 + gen() % (g1 - g0)), g.length);
+                const std::string reply = timed("GUESS " + g.id + " " + guess);
+
+                if (reply.rfind("WIN", 0) == 0)
+                {
+                    unsigned int length;
+                    char letter;
+                    if (std::sscanf(reply.c_str(), "WIN %*s %*u %u %c", &length, &letter) == 2)
+                        g.length = length, g.letter = letter;
+                }
+                else if (reply.rfind("LOSE", 0) == 0)
+                {
+                    timed("END " + g.id + " load" + std::to_string(w));
+                    if (timed("TOP 10").rfind("OK", 0) != 0) failed++;
+                    if (!ParseNew(timed("NEW"), g)) failed++;
+                }
+                else if (reply.rfind("VALID", 0) != 0)
+                {
+                    failed++;
+                }
+            }
+        }
+
+        std::lock_guard lock(mutex);
+        latencies.insert(latencies.end(), local.begin(), local.end());
+        failures += failed;
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t w = 0; w < connections; ++w)
+        threads.emplace_back(worker, w);
+    for (auto& t : threads)
+        t.join();
+
+    if (latencies.empty())
+        return 1;
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&](double p) {
+        return latencies[std::min(latencies.size() - 1, (std::size_t)(p * latencies.size()))];
+    };
+    std::cout << latencies.size() << " requests over " << sessions << " sessions, " << failures << " failures" << std::endl;
+    std::cout << "Latency: p50 " << percentile(0.5) << " us, p99 " << percentile(0.99) 
+              << " us, max " << latencies.back() << " us" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
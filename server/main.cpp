@@ -0,0 +1,68 @@
+#include <csignal>
+#include <chrono>
+
+#include "server.h"
+
+// Multi-session Tomus server, see server.h for the protocol.
+//
+// Usage: tomus_server [config.json] [--unix path | --tcp port] [--seed n] [--leaderboard base]
+//
+// Runs recorded with END are kept in <base>.log/.idx when --leaderboard is
+// given (see Leaderboard), in memory only otherwise.
+
+Server* running = nullptr;
+
+void OnSignal(int)
+{
+    if (running) running->Stop();
+}
+
+int main(int argc, char** argv)
+{
+    std::string configPath = "res/config.json";
+    std::string unixPath = "/tmp/tomus.sock";
+    std::string leaderboardPath;
+    int port = -1;
+    uint64_t seed = std::chrono::steady_clock::now().time_since_epoch().count();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--unix" && i + 1 < argc)      unixPath = argv[++i];
+        else if (arg == "--tcp" && i + 1 < argc)  port = std::stoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i]);
+        else if (arg == "--leaderboard" && i + 1 < argc) leaderboardPath = argv[++i];
+        else                                      configPath = arg;
+    }
+
+    // Sessions only ever read the config
+    const Config conf = LoadConfig(configPath);
+    SessionPool pool(conf, seed);
+
+    // The store outlives the board, which saves its last entries when it goes
+    Leaderboard store;
+    if (!leaderboardPath.empty() && !store.Open(leaderboardPath))
+    {
+        std::cerr << "Error, can not open leaderboard: " << leaderboardPath << ".log" << std::endl;
+        return 1;
+    }
+    SharedLeaderboard board(Leaderboard::kIndexSize, leaderboardPath.empty() ? nullptr : &store);
+    Server server(pool, board);
+
+    const bool listening = port >= 0 ? server.ListenTcp(port) : server.ListenUnix(unixPath);
+    if (!listening)
+    {
+        std::cerr << "Error, can not listen on: " << (port >= 0 ? std::to_string(port) : unixPath) << std::endl;
+        return 1;
+    }
+    std::cout << "Listening on " << (port >= 0 ? "127.0.0.1:" + std::to_string(port) : unixPath) << std::endl;
+
+    running = &server;
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    server.Run();
+    running = nullptr;
+    return 0;
+}
@@ -0,0 +1,415 @@
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <ctime>
+
+#include "server.h"
+
+static bool SetNonBlocking(int fd)
+{
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Split the next space separated token off line
+static std::string_view Token(std::string_view& line)
+{
+    const auto start = line.find_first_not_of(' ');
+    if (start == std::string_view::npos)
+    {
+        line = {};
+        return {};
+    }
+    line.remove_prefix(start);
+
+    const auto end = line.find(' ');
+    const std::string_view token = line.substr(0, end);
+    line.remove_prefix(end == std::string_view::npos ? line.size() : end);
+    return token;
+}
+
+static void AppendFeedback(std::string& reply, Pattern p, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+        reply += (char)('0' + (int)PatternState(p, i));
+}
+
+static bool ValidName(std::string_view name)
+{
+    return !name.empty() && name.size() <= 32 && std::all_of(name.begin(), name.end(), [](char c) {
+        return std::isalnum((unsigned char)c) || c == '-' || c == '_';
+    });
+}
+
+static const char* ResultName(InputResult r)
+{
+    switch (r)
+    {
+        case InputResult::WRONG_LENGTH: return "WRONG_LENGTH";
+        case InputResult::WRONG_LETTER: return "WRONG_LETTER";
+        case InputResult::UNKNOWN_WORD: return "UNKNOWN_WORD";
+        case InputResult::VALID:        return "VALID";
+        case InputResult::WIN:          return "WIN";
+        case InputResult::LOSE:         return "LOSE";
+    }
+    return "ERR";
+}
+
+Server::Server(SessionPool& p, SharedLeaderboard& b) : pool(p), board(b)
+{
+    epoll = epoll_create1(0);
+}
+
+Server::~Server()
+{
+    for (auto& c : connections)
+    {
+        if (c) close(c->fd);
+    }
+    if (listener >= 0) close(listener);
+    if (epoll >= 0) close(epoll);
+    if (!unixPath.empty()) unlink(unixPath.c_str());
+}
+
+bool Server::ListenUnix(const std::string& path)
+{
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path))
+        return false;
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    unixPath = path;
+    return Listen(fd);
+}
+
+bool Server::ListenTcp(uint16_t port)
+{
+    // Local only: the server is meant to sit behind something else
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    const int one = 1;
+    if (fd < 0)
+        return false;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    return Listen(fd);
+}
+
+bool Server::Listen(int fd)
+{
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (listen(fd, SOMAXCONN) != 0 || !SetNonBlocking(fd) || epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    listener = fd;
+    return true;
+}
+
+static_assert(std::atomic<bool>::is_always_lock_free, "Stop is called from signal handlers");
+
+void Server::Run()
+{
+    epoll_event events[256];
+    while (!stopped)
+    {
+        const int n = epoll_wait(epoll, events, 256, 100);
+        for (int i = 0; i < n; ++i)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == listener)
+            {
+                Accept();
+                continue;
+            }
+
+            if (fd >= (int)connections.size() || !connections[fd])
+                continue;
+
+            Connection& c = *connections[fd];
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                Drop(fd);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT)
+                Flush(c);
+            if ((events[i].events & EPOLLIN) && connections[fd])
+                Read(c);
+        }
+    }
+}
+
+void Server::Stop()
+{
+    stopped = true;
+}
+
+void Server::Accept()
+{
+    while (true)
+    {
+        const int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0)
+            return;
+
+        const int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Fails silently on unix sockets
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (!SetNonBlocking(fd) || epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &ev) != 0)
+        {
+            close(fd);
+            continue;
+        }
+
+        if (fd >= (int)connections.size())
+            connections.resize(fd + 1);
+        connections[fd] = std::make_unique<Connection>();
+        connections[fd]->fd = fd;
+        connections[fd]->events = EPOLLIN;
+        connectionCount++;
+    }
+}
+
+void Server::Read(Connection& c)
+{
+    // What is left stays in the socket, epoll reports it again next wait
+    char buffer[16 * 1024];
+    for (std::size_t budget = kReadBudget; budget > 0 && c.out.size() <= kOutHighWater; )
+    {
+        const ssize_t n = read(c.fd, buffer, std::min(sizeof(buffer), budget));
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            Drop(c.fd);
+            return;
+        }
+        if (n < 0)
+            break;
+        budget -= n;
+        c.in.append(buffer, n);
+
+        // Handle every complete line, keep the rest for later
+        std::size_t start = 0;
+        while (true)
+        {
+            const std::size_t end = c.in.find('\n', start);
+            if (end == std::string::npos)
+                break;
+
+            std::string_view line(c.in.data() + start, end - start);
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+
+            Handle(line, c.out);
+            c.out += '\n';
+            start = end + 1;
+        }
+        c.in.erase(0, start);
+
+        // A client not sending lines is not a client
+        if (c.in.size() > kMaxLine)
+        {
+            Drop(c.fd);
+            return;
+        }
+    }
+
+    Flush(c);
+}
+
+void Server::Flush(Connection& c)
+{
+    std::size_t sent = 0;
+    while (sent < c.out.size())
+    {
+        const ssize_t n = write(c.fd, c.out.data() + sent, c.out.size() - sent);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                break;
+            Drop(c.fd);
+            return;
+        }
+        sent += n;
+    }
+    c.out.erase(0, sent);
+    Watch(c);
+}
+
+void Server::Watch(Connection& c)
+{
+    // Only wait for writability while there is something left to write, and
+    // stop reading a client that leaves its replies pending
+    uint32_t events = c.events & EPOLLIN;
+    if (c.out.size() > kOutHighWater)
+        events = 0;
+    else if (c.out.size() < kOutLowWater)
+        events = EPOLLIN;
+    if (!c.out.empty())
+        events |= EPOLLOUT;
+
+    if (events != c.events)
+    {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = c.fd;
+        epoll_ctl(epoll, EPOLL_CTL_MOD, c.fd, &ev);
+        c.events = events;
+    }
+}
+
+void Server::Drop(int fd)
+{
+    epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections[fd].reset();
+    connectionCount--;
+}
+
+void Server::Handle(std::string_view line, std::string& reply)
+{
+    const std::string_view command = Token(line);
+
+    if (command == "NEW")
+    {
+        const SessionId id = pool.Open();
+        const Session& s = *pool.Get(id);
+        reply += "OK " + std::to_string(id) + " " + std::to_string(s.length) + " " + UnpackLetter(s.answer, s.length, 0);
+        return;
+    }
+    if (command == "STATS")
+    {
+        reply += "OK " + std::to_string(pool.Size()) + " " + std::to_string(connectionCount);
+        return;
+    }
+    if (command == "TOP")
+    {
+        const std::string_view kToken = Token(line);
+        std::size_t k = 10;
+        if (!kToken.empty() && std::from_chars(kToken.data(), kToken.data() + kToken.size(), k).ec != std::errc{})
+        {
+            reply += "ERR invalid count";
+            return;
+        }
+
+        const auto top = board.Top(k);
+        reply += "OK " + std::to_string(top.size());
+        for (const LeaderboardSummary& e : top)
+            reply += " " + e.name + ":" + std::to_string(e.score) + ":" + std::to_string(e.wordCount);
+        return;
+    }
+
+    const std::string_view idToken = Token(line);
+    SessionId id = 0;
+    const auto parsed = std::from_chars(idToken.data(), idToken.data() + idToken.size(), id);
+    Session* s = (parsed.ec == std::errc{}) ? pool.Get(id) : nullptr;
+
+    if (command != "GUESS" && command != "STATE" && command != "END")
+    {
+        reply += "ERR unknown command";
+        return;
+    }
+    if (!s)
+    {
+        reply += "ERR unknown session";
+        return;
+    }
+
+    if (command == "GUESS")
+    {
+        if (s->over)
+        {
+            reply += "ERR game over";
+            return;
+        }
+
+        const InputResult r = pool.Input(*s, Token(line));
+        reply += ResultName(r);
+        if (r != InputResult::VALID && r != InputResult::WIN && r != InputResult::LOSE)
+            return;
+
+        reply += ' ';
+        AppendFeedback(reply, s->patterns[s->tries - 1], s->length);
+
+        if (r == InputResult::WIN)
+        {
+            pool.NewWord(*s);
+            reply += " " + std::to_string(s->score) + " " + std::to_string(s->length) + " " + UnpackLetter(s->answer, s->length, 0);
+        }
+        else if (r == InputResult::LOSE)
+        {
+            reply += " " + UnpackWord(s->answer, s->length) + " " + std::to_string(s->score);
+        }
+    }
+    else if (command == "STATE")
+    {
+        reply += "OK " + std::to_string(s->score) + " " + std::to_string(s->words) + " " 
+               + std::to_string(s->length) + " " + UnpackLetter(s->answer, s->length, 0);
+        for (uint32_t t = 0; t < s->tries; ++t)
+        {
+            reply += " " + UnpackWord(s->guesses[t], s->length) + ":";
+            AppendFeedback(reply, s->patterns[t], s->length);
+        }
+    }
+    else
+    {
+        const std::string_view name = Token(line);
+        if (!name.empty() && !ValidName(name))
+        {
+            reply += "ERR invalid name";
+            return;
+        }
+        reply += "OK " + std::to_string(s->score) + " " + std::to_string(s->words);
+
+        // Server runs are not timed
+        if (!name.empty())
+        {
+            const time_t now = time(nullptr);
+            const struct tm* tm = localtime(&now);
+
+            LeaderboardEntry entry;
+            entry.name = name;
+            entry.score = s->score;
+            entry.wordCount = s->words;
+            entry.day = tm->tm_mday;
+            entry.month = tm->tm_mon + 1;
+            entry.year = 1900 + tm->tm_year;
+            board.Insert(std::move(entry));
+        }
+        pool.Close(id);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "tomus/session.h"
+#include "tomus/sharedboard.h"
+
+// Single threaded, epoll based server hosting many Tomus sessions over a
+// local socket. The protocol is line based, one reply line per request:
+//
+//   NEW                 -> OK <id> <length> <first letter>
+//   GUESS <id> <word>   -> VALID <feedback>
+//                          WIN <feedback> <score> <next length> <next first letter>
+//                          LOSE <feedback> <answer> <score>
+//                          WRONG_LENGTH | WRONG_LETTER | UNKNOWN_WORD
+//   STATE <id>          -> OK <score> <words> <length> <first letter> [<guess>:<feedback>]...
+//   END <id> [<name>]   -> OK <score> <words>
+//   TOP [<k>]           -> OK <count> [<name>:<score>:<words>]...
+//   STATS               -> OK <sessions> <connections>
+//
+// Feedback has one digit per letter: 0 good position, 1 in word, 2 not in word.
+// Errors are reported as ERR <reason>.
+//
+// END with a name (up to 32 letters, digits, '-' or '_') records the run in
+// the leaderboard, TOP reads its best k runs (10 by default). Both go through
+// a SharedLeaderboard: the event loop never ranks nor writes entries itself,
+// and its reads take no lock.
+//
+// Connections share the event loop fairly: a wakeup reads at most kReadBudget
+// bytes of a connection, and a client not reading its replies stops being
+// read once kOutHighWater bytes wait for it, until they drain below
+// kOutLowWater. Lines longer than kMaxLine drop the connection.
+struct Server
+{
+    static constexpr std::size_t kMaxLine = 4096;
+    static constexpr std::size_t kReadBudget = 64 * 1024;
+    static constexpr std::size_t kOutHighWater = 256 * 1024;
+    static constexpr std::size_t kOutLowWater = 64 * 1024;
+
+    Server(SessionPool& pool, SharedLeaderboard& board);
+    ~Server();
+
+    bool ListenUnix(const std::string& path);
+    bool ListenTcp(uint16_t port);
+
+    // Serve until Stop is called (eg. from a signal handler, even before Run)
+    void Run();
+    void Stop();
+private:
+    struct Connection
+    {
+        int fd = -1;
+        std::string in;
+        std::string out;
+        uint32_t events = 0;    // epoll interest
+    };
+
+    bool Listen(int fd);
+    void Accept();
+    void Read(Connection& c);
+    void Flush(Connection& c);
+    void Watch(Connection& c);
+    void Drop(int fd);
+    void Handle(std::string_view line, std::string& reply);
+
+    SessionPool& pool;
+    SharedLeaderboard& board;
+    int epoll = -1;
+    int listener = -1;
+    std::string unixPath;
+    std::atomic<bool> stopped{false}; // Lock free, written by signal handlers
+    std::vector<std::unique_ptr<Connection>> connections; // by fd
+    std::size_t connectionCount = 0;
+};
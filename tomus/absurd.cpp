@@ -0,0 +1,149 @@
+#include <algorithm>
+
+#include "absurd.h"
+#include "parallel.h"
+#include "profile.h"
+
+// Letters of a pattern in GOOD_POSITION, the forced first one left out
+static uint32_t Placed(Pattern p, uint32_t length)
+{
+    uint32_t placed = 0;
+    for (uint32_t i = 1; i < length; ++i, p /= 3)
+        placed += p % 3 == (Pattern)State::GOOD_POSITION;
+    return placed;
+}
+
+Pattern PatternPartition::Largest(uint64_t guess, std::span<const uint64_t> candidates, uint32_t length)
+{
+    TOMUS_PROFILE_SCOPE("PatternPartition::Largest");
+    const std::size_t n = candidates.size();
+    const uint32_t classes = PatternCount(length);
+    const unsigned int workers = n >= kParallelMin ? WorkerCount() : 1;
+
+    patterns.resize(n);
+    if (scratch.size() < workers)
+        scratch.resize(workers);
+    for (Scratch& s : scratch)
+        if (s.counts.size() < classes)
+            s.counts.assign(classes, 0);
+
+    const auto count = [&](std::size_t begin, std::size_t end, Scratch& s) {
+        ComputeFeedbacks(guess, candidates.data() + begin, end - begin, length, patterns.data() + begin);
+        for (std::size_t i = begin; i < end; ++i)
+            if (s.counts[patterns[i]]++ == 0)
+                s.used.push_back(patterns[i]);
+    };
+
+    if (workers == 1)
+        count(0, n, scratch[0]);
+    else
+        ParallelFor((n + kBlock - 1) / kBlock, [&](std::size_t b, unsigned int worker) {
+            count(b * kBlock, std::min(n, (b + 1) * kBlock), scratch[worker]);
+        }, 1);
+
+    // Merge into the first table, leaving the others cleared
+    Scratch& total = scratch[0];
+    for (std::size_t w = 1; w < scratch.size(); ++w)
+    {
+        for (const Pattern p : scratch[w].used)
+        {
+            if (total.counts[p] == 0)
+                total.used.push_back(p);
+            total.counts[p] += scratch[w].counts[p];
+            scratch[w].counts[p] = 0;
+        }
+        scratch[w].used.clear();
+    }
+
+    Pattern best = kWinPattern;
+    uint32_t bestCount = 0, bestPlaced = 0;
+    for (const Pattern p : total.used)
+    {
+        const uint32_t c = total.counts[p];
+        const uint32_t placed = Placed(p, length);
+        const bool tie = c == bestCount && p != kWinPattern
+                      && (best == kWinPattern || placed < bestPlaced || (placed == bestPlaced && p > best));
+        if (c > bestCount || tie)
+        {
+            best = p;
+            bestCount = c;
+            bestPlaced = placed;
+        }
+        total.counts[p] = 0;
+    }
+    total.used.clear();
+    return best;
+}
+
+AbsurdGame::AbsurdGame(Tomus& t) : tomus(t), solutions(kMaxFeedbackLength + 1)
+{
+    const Config& conf = tomus.config;
+    for (std::size_t i = 0; i < conf.words.size(); ++i)
+    {
+        const std::string_view w = conf.words[i];
+        uint64_t code;
+        if (w.size() >= 2 && w.size() <= kMaxFeedbackLength && PackWord(w, code))
+            solutions[w.size()].emplace_back(code, i);
+    }
+    for (auto& s : solutions)
+        std::sort(s.begin(), s.end());
+}
+
+void AbsurdGame::NewWord()
+{
+    tomus.NewWord();
+    Reset();
+}
+
+void AbsurdGame::Reset()
+{
+    codes.clear();
+    indices.clear();
+
+    const PackedWord word = tomus.Tries()[0].word;
+    const uint32_t length = word.size();
+    if (length < 2 || length > kMaxFeedbackLength)
+        return;
+
+    // The first letter is the top field of the packed words
+    const uint32_t shift = kLetterBits * (length - 1);
+    const uint64_t first = (word.Code() >> shift) << shift;
+    const auto& s = solutions[length];
+    auto it = std::lower_bound(s.begin(), s.end(), std::make_pair(first, uint32_t(0)));
+    for (; it != s.end() && (it->first >> shift) == (first >> shift); ++it)
+    {
+        codes.push_back(it->first);
+        indices.push_back(it->second);
+    }
+}
+
+InputResult AbsurdGame::Input(const std::string& input)
+{
+    const Try& last = tomus.Tries().back();
+    const uint32_t length = last.word.size();
+
+    // Refused inputs do not narrow anything, Tomus refuses them the same way
+    uint64_t guess;
+    Pattern pattern;
+    const InputResult r = ScoreInput(tomus.config, last.word.Code(), length, input, guess, pattern);
+    if ((r != InputResult::VALID && r != InputResult::WIN) || codes.empty())
+        return tomus.Input(input);
+
+    const Pattern kept = partition.Largest(guess, codes, length);
+    const auto patterns = partition.Patterns();
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < codes.size(); ++i)
+    {
+        if (patterns[i] != kept)
+            continue;
+        codes[n] = codes[i];
+        indices[n] = indices[i];
+        n++;
+    }
+    codes.resize(n);
+    indices.resize(n);
+
+    if (pattern != kept)
+        tomus.SwapWord(indices[0]);
+    return tomus.Input(input);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "tomus.h"
+
+// Splits candidate answers by the feedback they give to a guess. Patterns
+// come from ComputeFeedbacks and classes are counted in a table indexed by
+// pattern code (3^(length - 1) entries, only the used ones are cleared after).
+// Large sets are split over all cores, each worker counting in its own
+// scratch table, merged at the end.
+struct PatternPartition
+{
+    static constexpr std::size_t kParallelMin = 1 << 14;
+    static constexpr std::size_t kBlock = 4096;
+
+    // Pattern of the largest class of candidates; ties go to the class with
+    // the fewest letters in GOOD_POSITION, then to the highest code, a win
+    // being the last resort
+    Pattern Largest(uint64_t guess, std::span<const uint64_t> candidates, uint32_t length);
+
+    // Patterns of the candidates of the last call
+    std::span<const Pattern> Patterns() const
+    {
+        return patterns;
+    }
+private:
+    struct Scratch
+    {
+        std::vector<uint32_t> counts;
+        std::vector<Pattern> used;
+    };
+
+    std::vector<Scratch> scratch; // By ParallelFor worker
+    std::vector<Pattern> patterns;
+};
+
+// Absurd mode: the answer is never committed to. Each guess keeps the largest
+// class of the remaining solutions (same length and first letter) sharing a
+// feedback, and the game's word is swapped for one of them when needed, so
+// Tomus scores, logs and draws the game as usual.
+struct AbsurdGame
+{
+    AbsurdGame(Tomus& tomus);
+
+    // Tomus::NewWord, then every solution of that length and first letter
+    // is still possible
+    void NewWord();
+
+    // Tomus::Input once the answer is settled
+    InputResult Input(const std::string& input);
+
+    std::size_t Candidates() const
+    {
+        return codes.size();
+    }
+private:
+    void Reset();
+
+    Tomus& tomus;
+    std::vector<std::vector<std::pair<uint64_t, uint32_t>>> solutions; // By length, (packed, word index) sorted
+
+    // Remaining candidates, packed words and their indices in Config::words
+    std::vector<uint64_t> codes;
+    std::vector<uint32_t> indices;
+    PatternPartition partition;
+};
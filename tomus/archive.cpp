@@ -0,0 +1,489 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+#include "archive.h"
+#include "dictionary.h"
+#include "parallel.h"
+#include "tomus.h"
+
+constexpr char     kColumnarMagic[8] = {'T', 'O', 'M', 'U', 'S', 'C', 'O', 'L'};
+constexpr uint32_t kColumnarVersion  = 1;
+
+// Deepest nesting a chunk may start at, entries are at depth 1 and their
+// guesses at 3
+constexpr uint32_t kMaxDepth = 16;
+constexpr uint64_t kNoOffset = ~uint64_t(0);
+
+struct ColumnarHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t padding;
+};
+
+struct GroupHeader
+{
+    uint32_t entries;
+    uint32_t games;
+    uint32_t guesses;
+    uint32_t nameBytes;
+};
+
+struct ColumnarTrailer
+{
+    uint64_t footerOffset;
+    uint64_t groupCount;
+    char magic[8];
+};
+
+// Outcome of a chunk scanned from each string state (0 outside, 1 inside)
+struct ChunkScan
+{
+    uint8_t end[2];
+    int32_t depth[2];                       // Nesting change
+    uint64_t first[2][kMaxDepth + 1];       // First entry, by depth at the chunk start
+};
+
+static void ScanChunk(const char* data, uint64_t begin, uint64_t end, ChunkScan& scan)
+{
+    for (uint8_t start = 0; start < 2; ++start)
+    {
+        bool inside = start, escaped = false;
+        int32_t depth = 0;
+        std::fill(std::begin(scan.first[start]), std::end(scan.first[start]), kNoOffset);
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            const char c = data[i];
+            if (inside)
+            {
+                if (escaped)
+                    escaped = false;
+                else if (c == '\\')
+                    escaped = true;
+                else if (c == '"')
+                    inside = false;
+            }
+            else if (c == '"')
+                inside = true;
+            else if (c == '{' || c == '[')
+            {
+                // An object opened at depth 1 is an entry
+                const int32_t at = 1 - depth;
+                if (c == '{' && at >= 0 && at <= (int32_t)kMaxDepth && scan.first[start][at] == kNoOffset)
+                    scan.first[start][at] = i;
+                depth++;
+            }
+            else if (c == '}' || c == ']')
+                depth--;
+        }
+        scan.end[start] = inside;
+        scan.depth[start] = depth;
+    }
+}
+
+// Builds the entries of a json array of them, ignoring unknown fields
+struct EntryHandler
+{
+    using json = nlohmann::json;
+
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number_integer(json::number_integer_t v) { return Number(v); }
+    bool number_unsigned(json::number_unsigned_t v)
+    {
+        if (depth == 2 && field == "seed")
+            entry.seed = v;
+        return Number(v);
+    }
+    bool number_float(json::number_float_t v, const json::string_t&) { return Number(v); }
+    bool binary(json::binary_t&) { return true; }
+
+    bool string(json::string_t& s)
+    {
+        if (depth == 2 && field == "name")
+            entry.name = s;
+        else if (depth == 4 && guesses)
+        {
+            // Initial tries ("m......") are not guesses and do not pack
+            uint64_t code;
+            if (s.size() < kMaxPackedLength && PackWord(s, code))
+                entry.guesses.back().push_back(PackedWord(code, s.size()).bits);
+        }
+        return true;
+    }
+
+    bool key(json::string_t& k)
+    {
+        if (depth == 2)
+            field = k;
+        return true;
+    }
+
+    bool start_object(std::size_t)
+    {
+        if (++depth == 2)
+            entry = {};
+        return true;
+    }
+
+    bool end_object()
+    {
+        if (depth-- == 2)
+            entries.push_back(std::move(entry));
+        return true;
+    }
+
+    bool start_array(std::size_t)
+    {
+        if (++depth == 3)
+            guesses = field == "guesses";
+        else if (depth == 4 && guesses)
+            entry.guesses.push_back({});
+        return true;
+    }
+
+    bool end_array()
+    {
+        if (depth-- == 3)
+            guesses = false;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const json::exception& e)
+    {
+        error = e.what();
+        return false;
+    }
+
+    template<typename T>
+    bool Number(T v)
+    {
+        if (depth != 2)
+            return true;
+        if (field == "score")           entry.score = v;
+        else if (field == "wordCount")  entry.wordCount = v;
+        else if (field == "time")       entry.time = v;
+        else if (field == "year")       entry.year = v;
+        else if (field == "month")      entry.month = v;
+        else if (field == "day")        entry.day = v;
+        else if (field == "puzzle")     entry.puzzle = v;
+        return true;
+    }
+
+    std::vector<LeaderboardEntry> entries;
+    LeaderboardEntry entry;
+    std::string field;
+    uint32_t depth = 0;
+    bool guesses = false;
+    std::string error;
+};
+
+static bool IsSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool ScanJsonArchive(const std::string& path, const ArchiveVisitor& visit, std::string& error, std::size_t chunkSize)
+{
+    auto file = MappedFile::Open(path);
+    if (!file)
+    {
+        error = "can not open " + path;
+        return false;
+    }
+    const auto* data = reinterpret_cast<const char*>(file->data);
+    const uint64_t size = file->size;
+
+    uint64_t open = 0;
+    while (open < size && IsSpace(data[open]))
+        ++open;
+    if (open == size || data[open] != '[')
+    {
+        error = path + " is not a json array";
+        return false;
+    }
+
+    // Chunks never start right after a backslash, it could escape their
+    // first character
+    std::vector<uint64_t> starts;
+    for (uint64_t s = 0; s < size; s += std::max<std::size_t>(chunkSize, 1))
+    {
+        uint64_t start = s;
+        while (start > 0 && start < size && data[start - 1] == '\\')
+            ++start;
+        if (start < size && (starts.empty() || start > starts.back()))
+            starts.push_back(start);
+    }
+
+    std::vector<ChunkScan> scans(starts.size());
+    ParallelFor(starts.size(), [&](std::size_t c, unsigned int) {
+        ScanChunk(data, starts[c], c + 1 < starts.size() ? starts[c + 1] : size, scans[c]);
+    }, 1);
+
+    // Chain the chunks: the file starts outside of any string, at depth 0
+    std::vector<uint64_t> entries;
+    uint8_t state = 0;
+    int32_t depth = 0;
+    for (const ChunkScan& scan : scans)
+    {
+        if (depth < 0 || depth > (int32_t)kMaxDepth)
+            break;
+        if (scan.first[state][depth] != kNoOffset)
+            entries.push_back(scan.first[state][depth]);
+        depth += scan.depth[state];
+        state = scan.end[state];
+    }
+    if (depth != 0 || state != 0)
+    {
+        error = path + " is truncated or not valid json";
+        return false;
+    }
+
+    // Each region, from the first entry of a chunk to the next one, is
+    // parsed as an array of its own
+    std::vector<std::string> buffers(WorkerCount());
+    std::vector<EntryHandler> handlers(WorkerCount());
+    std::atomic<bool> failed = false;
+    std::mutex errorMutex;
+    ParallelFor(entries.size(), [&](std::size_t r, unsigned int worker) {
+        if (failed)
+            return;
+
+        const uint64_t begin = entries[r];
+        uint64_t end = r + 1 < entries.size() ? entries[r + 1] : size;
+        while (end > begin && IsSpace(data[end - 1]))
+            --end;
+        if (end > begin && (data[end - 1] == ',' || data[end - 1] == ']'))
+            --end;
+
+        std::string& buffer = buffers[worker];
+        buffer.assign(1, '[');
+        buffer.append(data + begin, end - begin);
+        buffer += ']';
+
+        EntryHandler& handler = handlers[worker];
+        handler.entries.clear();
+        handler.depth = 0;
+        if (!nlohmann::json::sax_parse(buffer, &handler))
+        {
+            std::lock_guard lock(errorMutex);
+            if (!failed)
+                error = path + ", entries from byte " + std::to_string(begin) + ": " + handler.error;
+            failed = true;
+            return;
+        }
+        visit(handler.entries, r, worker);
+    }, 1);
+
+    return !failed;
+}
+
+ColumnarWriter::~ColumnarWriter()
+{
+    if (file)
+        Close();
+}
+
+bool ColumnarWriter::Open(const std::string& path)
+{
+    file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    ColumnarHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kColumnarMagic, sizeof(header.magic));
+    header.version = kColumnarVersion;
+    failed = std::fwrite(&header, sizeof(header), 1, file) != 1;
+    size = sizeof(header);
+    groups.clear();
+    return !failed;
+}
+
+template<typename T>
+static void AppendColumn(std::vector<char>& out, const std::vector<T>& column)
+{
+    const char* bytes = reinterpret_cast<const char*>(column.data());
+    out.insert(out.end(), bytes, bytes + column.size() * sizeof(T));
+    out.resize((out.size() + 7) & ~std::size_t(7), 0);
+}
+
+bool ColumnarWriter::Append(std::size_t chunk, std::span<const LeaderboardEntry> entries)
+{
+    if (entries.empty())
+        return true;
+
+    std::vector<uint64_t> seed, guesses;
+    std::vector<int32_t> score, wordCount, time;
+    std::vector<uint32_t> puzzle, nameEnds, gameEnds, guessEnds;
+    std::vector<uint16_t> year;
+    std::vector<uint8_t> month, day;
+    std::vector<char> names;
+    for (const LeaderboardEntry& e : entries)
+    {
+        seed.push_back(e.seed);
+        score.push_back(e.score);
+        wordCount.push_back(e.wordCount);
+        time.push_back(e.time);
+        puzzle.push_back(e.puzzle);
+        year.push_back(e.year);
+        month.push_back(e.month);
+        day.push_back(e.day);
+        names.insert(names.end(), e.name.begin(), e.name.end());
+        nameEnds.push_back(names.size());
+        for (const auto& game : e.guesses)
+        {
+            guesses.insert(guesses.end(), game.begin(), game.end());
+            guessEnds.push_back(guesses.size());
+        }
+        gameEnds.push_back(guessEnds.size());
+    }
+
+    const GroupHeader header = {(uint32_t)entries.size(), (uint32_t)guessEnds.size(), (uint32_t)guesses.size(), (uint32_t)names.size()};
+    std::vector<char> group(reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header) + sizeof(header));
+    AppendColumn(group, seed);
+    AppendColumn(group, guesses);
+    AppendColumn(group, score);
+    AppendColumn(group, wordCount);
+    AppendColumn(group, time);
+    AppendColumn(group, puzzle);
+    AppendColumn(group, nameEnds);
+    AppendColumn(group, gameEnds);
+    AppendColumn(group, guessEnds);
+    AppendColumn(group, year);
+    AppendColumn(group, month);
+    AppendColumn(group, day);
+    AppendColumn(group, names);
+
+    std::lock_guard lock(mutex);
+    if (!file || failed || std::fwrite(group.data(), group.size(), 1, file) != 1)
+        return !(failed = true);
+    groups.push_back({chunk, size, group.size()});
+    size += group.size();
+    return true;
+}
+
+bool ColumnarWriter::Close()
+{
+    std::lock_guard lock(mutex);
+    if (!file)
+        return false;
+
+    std::sort(groups.begin(), groups.end(), [](const GroupInfo& a, const GroupInfo& b) { return a.chunk < b.chunk; });
+    ColumnarTrailer trailer;
+    std::memset(&trailer, 0, sizeof(trailer));
+    trailer.footerOffset = size;
+    trailer.groupCount = groups.size();
+    std::memcpy(trailer.magic, kColumnarMagic, sizeof(trailer.magic));
+
+    if (!groups.empty() && std::fwrite(groups.data(), groups.size() * sizeof(GroupInfo), 1, file) != 1)
+        failed = true;
+    if (std::fwrite(&trailer, sizeof(trailer), 1, file) != 1)
+        failed = true;
+    if (std::fclose(file) != 0)
+        failed = true;
+    file = nullptr;
+    return !failed;
+}
+
+// Column of count values at cursor, moved past it; false when it overruns end
+template<typename T>
+static bool ReadColumn(const char*& cursor, const char* end, std::size_t count, std::span<const T>& column)
+{
+    const std::size_t bytes = count * sizeof(T);
+    const std::size_t padded = (bytes + 7) & ~std::size_t(7);
+    if (std::size_t(end - cursor) < padded)
+        return false;
+    column = std::span<const T>(reinterpret_cast<const T*>(cursor), count);
+    cursor += padded;
+    return true;
+}
+
+// Prefix ends are non decreasing and end at total
+static bool ValidEnds(std::span<const uint32_t> ends, uint32_t total)
+{
+    return std::is_sorted(ends.begin(), ends.end()) && (ends.empty() ? total == 0 : ends.back() == total);
+}
+
+bool ColumnarArchive::Open(const std::string& path)
+{
+    auto file = MappedFile::Open(path);
+    if (!file || file->size < sizeof(ColumnarHeader) + sizeof(ColumnarTrailer))
+        return false;
+
+    ColumnarHeader header;
+    ColumnarTrailer trailer;
+    std::memcpy(&header, file->data, sizeof(header));
+    std::memcpy(&trailer, file->data + file->size - sizeof(trailer), sizeof(trailer));
+    if (std::memcmp(header.magic, kColumnarMagic, sizeof(header.magic)) != 0 || header.version != kColumnarVersion)
+        return false;
+    if (std::memcmp(trailer.magic, kColumnarMagic, sizeof(trailer.magic)) != 0)
+        return false;
+
+    struct GroupInfo
+    {
+        uint64_t chunk;
+        uint64_t offset;
+        uint64_t size;
+    };
+    if (trailer.footerOffset > file->size || (file->size - sizeof(trailer) - trailer.footerOffset) != trailer.groupCount * sizeof(GroupInfo))
+        return false;
+
+    std::vector<ColumnGroup> loaded;
+    for (uint64_t g = 0; g < trailer.groupCount; ++g)
+    {
+        GroupInfo info;
+        std::memcpy(&info, file->data + trailer.footerOffset + g * sizeof(GroupInfo), sizeof(info));
+        if (info.offset % 8 != 0 || info.offset > trailer.footerOffset || info.size > trailer.footerOffset - info.offset || info.size < sizeof(GroupHeader))
+            return false;
+
+        const auto* cursor = reinterpret_cast<const char*>(file->data + info.offset);
+        const char* end = cursor + info.size;
+        GroupHeader gh;
+        std::memcpy(&gh, cursor, sizeof(gh));
+        cursor += sizeof(gh);
+
+        ColumnGroup c;
+        std::span<const char> names;
+        const bool read = ReadColumn(cursor, end, gh.entries, c.seed)
+                       && ReadColumn(cursor, end, gh.guesses, c.guesses)
+                       && ReadColumn(cursor, end, gh.entries, c.score)
+                       && ReadColumn(cursor, end, gh.entries, c.wordCount)
+                       && ReadColumn(cursor, end, gh.entries, c.time)
+                       && ReadColumn(cursor, end, gh.entries, c.puzzle)
+                       && ReadColumn(cursor, end, gh.entries, c.nameEnds)
+                       && ReadColumn(cursor, end, gh.entries, c.gameEnds)
+                       && ReadColumn(cursor, end, gh.games, c.guessEnds)
+                       && ReadColumn(cursor, end, gh.entries, c.year)
+                       && ReadColumn(cursor, end, gh.entries, c.month)
+                       && ReadColumn(cursor, end, gh.entries, c.day)
+                       && ReadColumn(cursor, end, gh.nameBytes, names);
+        if (!read || !ValidEnds(c.nameEnds, gh.nameBytes) || !ValidEnds(c.gameEnds, gh.games) || !ValidEnds(c.guessEnds, gh.guesses))
+            return false;
+        c.names = std::string_view(names.data(), names.size());
+        loaded.push_back(c);
+    }
+
+    groups = std::move(loaded);
+    storage = file;
+    return true;
+}
+
+uint64_t ColumnarArchive::Entries() const
+{
+    uint64_t total = 0;
+    for (const ColumnGroup& g : groups)
+        total += g.Entries();
+    return total;
+}
+
+bool IsColumnarArchive(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[8] = {};
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, kColumnarMagic, sizeof(magic)) == 0;
+}
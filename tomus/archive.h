@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "leaderboard.h"
+
+// Readers of the archived runs of the former leaderboard.json (a json array
+// of entries, fields as in Leaderboard::ImportJson), for analytics over
+// files too large to load as a json document.
+//
+// ScanJsonArchive maps the file and cuts it into chunks parsed over all
+// cores, with nlohmann's SAX interface: only the entries of the chunks being
+// parsed are held, whatever the size of the archive. Entries are found
+// without a sequential pass: each chunk is scanned twice, as if it started
+// inside and outside of a string, recording where each nesting depth first
+// opens an object. Chaining the chunks from the start of the file then
+// picks the right scan and the first entry of each chunk (strings can not
+// hold a raw quote, and a chunk never starts after a backslash).
+//
+// Guesses are PackedWord bits, initial tries ("m......") are left out.
+
+constexpr std::size_t kArchiveChunkSize = 4 << 20;
+
+// Entries of one chunk, chunks numbering the file in order. Called from the
+// ParallelFor workers, worker being in [0, WorkerCount()).
+using ArchiveVisitor = std::function<void(std::span<const LeaderboardEntry> entries, std::size_t chunk, unsigned int worker)>;
+
+bool ScanJsonArchive(const std::string& path, const ArchiveVisitor& visit, std::string& error, std::size_t chunkSize = kArchiveChunkSize);
+
+// Columnar copy of an archive, for repeated queries. The file is a sequence
+// of row groups (one per json chunk, written as chunks finish) and a footer
+// listing them in chunk order:
+//
+//   "TOMUSCOL" version
+//   group...    GroupHeader then columns, 8 byte aligned: seed and guesses
+//               (u64); score, wordCount, time, puzzle, name ends, game ends
+//               (per entry) and guess ends (per game) (u32); year (u16);
+//               month, day and the names (u8)
+//   footer      GroupInfo per group, by chunk
+//   trailer     footer offset, group count, "TOMUSCOL"
+//
+// Ends are exclusive prefix sums within the group: entry i's games are
+// [gameEnds[i - 1], gameEnds[i]), 0 for the first.
+struct ColumnGroup
+{
+    std::span<const uint64_t> seed;
+    std::span<const uint64_t> guesses;
+    std::span<const int32_t> score;
+    std::span<const int32_t> wordCount;
+    std::span<const int32_t> time;
+    std::span<const uint32_t> puzzle;
+    std::span<const uint32_t> nameEnds;
+    std::span<const uint32_t> gameEnds;
+    std::span<const uint32_t> guessEnds;
+    std::span<const uint16_t> year;
+    std::span<const uint8_t> month;
+    std::span<const uint8_t> day;
+    std::string_view names;
+
+    std::size_t Entries() const
+    {
+        return score.size();
+    }
+
+    std::string_view Name(std::size_t entry) const
+    {
+        const uint32_t begin = entry ? nameEnds[entry - 1] : 0;
+        return names.substr(begin, nameEnds[entry] - begin);
+    }
+
+    // Game indices of an entry, for Game
+    std::pair<uint32_t, uint32_t> Games(std::size_t entry) const
+    {
+        return {entry ? gameEnds[entry - 1] : 0, gameEnds[entry]};
+    }
+
+    std::span<const uint64_t> Game(std::size_t game) const
+    {
+        const uint32_t begin = game ? guessEnds[game - 1] : 0;
+        return guesses.subspan(begin, guessEnds[game] - begin);
+    }
+};
+
+struct ColumnarWriter
+{
+    ColumnarWriter()
+    {}
+    ~ColumnarWriter();
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    bool Open(const std::string& path);
+
+    // Thread safe, chunks in any order
+    bool Append(std::size_t chunk, std::span<const LeaderboardEntry> entries);
+
+    // Footer and trailer, false when a write failed
+    bool Close();
+private:
+    struct GroupInfo
+    {
+        uint64_t chunk;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    std::mutex mutex;
+    std::FILE* file = nullptr;
+    uint64_t size = 0;
+    bool failed = false;
+    std::vector<GroupInfo> groups;
+};
+
+struct ColumnarArchive
+{
+    ColumnarArchive()
+    {}
+
+    bool Open(const std::string& path);
+
+    const std::vector<ColumnGroup>& Groups() const
+    {
+        return groups;
+    }
+
+    uint64_t Entries() const;
+private:
+    std::shared_ptr<const void> storage;
+    std::vector<ColumnGroup> groups;
+};
+
+// True when path starts like a columnar archive
+bool IsColumnarArchive(const std::string& path);
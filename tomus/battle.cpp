@@ -0,0 +1,144 @@
+#include <algorithm>
+
+#include "battle.h"
+#include "profile.h"
+
+static uint32_t BucketKey(uint32_t length, uint32_t letter)
+{
+    return length * 26 + letter;
+}
+
+Battle::Battle(const Config& c, uint64_t seed) : config(c), gen(seed)
+{
+    buckets.resize(BucketKey(kMaxFeedbackLength, 25) + 1);
+    for (std::size_t i = 0; i < config.words.size(); ++i)
+    {
+        const std::string_view w = config.words[i];
+        if (w.size() >= 2 && w.size() <= kMaxFeedbackLength)
+            buckets[BucketKey(w.size(), w[0] - 'a')].push_back(i);
+    }
+}
+
+bool Battle::NewRound(uint32_t count)
+{
+    count = std::clamp(count, 1u, kMaxBoards);
+
+    // A word drawn among the solutions of the large enough buckets picks the
+    // bucket, the bigger ones being more likely, as when drawing single words
+    std::size_t eligible = 0;
+    for (const auto& b : buckets)
+        if (b.size() >= count)
+            eligible += b.size();
+    if (eligible == 0)
+        return false;
+
+    std::size_t pick = gen.Below(eligible);
+    const std::vector<uint32_t>* bucket = nullptr;
+    for (const auto& b : buckets)
+    {
+        if (b.size() < count)
+            continue;
+        if (pick < b.size())
+        {
+            bucket = &b;
+            break;
+        }
+        pick -= b.size();
+    }
+
+    // Distinct answers: partial Fisher-Yates over a copy of the bucket
+    std::vector<uint32_t> words = *bucket;
+    for (uint32_t b = 0; b < count; ++b)
+    {
+        std::swap(words[b], words[b + gen.Below(words.size() - b)]);
+        const std::string_view w = config.words[words[b]];
+        PackWord(w, answers[b]);
+        answerIndices[b] = words[b];
+        solvedAt[b] = 0;
+    }
+    boards = count;
+    length = config.words[words[0]].size();
+    guesses.clear();
+    patterns.clear();
+    return true;
+}
+
+InputResult Battle::Input(const std::string& input)
+{
+    TOMUS_PROFILE_SCOPE("Battle::Input");
+    if (boards == 0)
+        return InputResult::WRONG_LENGTH;
+
+    // The rules are those of a single word, every board sharing the first letter
+    uint64_t guess;
+    Pattern pattern;
+    const InputResult r = ScoreInput(config, answers[0], length, input, guess, pattern);
+    if (r != InputResult::VALID && r != InputResult::WIN)
+        return r;
+    if (guesses.size() >= MaxTries())
+        return InputResult::LOSE;
+
+    guesses.push_back(guess);
+    patterns.emplace_back();
+    ComputeFeedbacks(guess, answers.data(), boards, length, patterns.back().data());
+
+    bool all = true;
+    for (uint32_t b = 0; b < boards; ++b)
+    {
+        if (solvedAt[b] == 0 && patterns.back()[b] == kWinPattern)
+            solvedAt[b] = guesses.size();
+        all = all && solvedAt[b] != 0;
+    }
+
+    if (all)
+        return InputResult::WIN;
+    if (guesses.size() >= MaxTries())
+        return InputResult::LOSE;
+    return InputResult::VALID;
+}
+
+void Battle::Tries(uint32_t board, std::vector<Try>& tries) const
+{
+    tries.clear();
+    tries.emplace_back(config.words[answerIndices[board]], answerIndices[board]);
+    const std::size_t end = solvedAt[board] != 0 ? solvedAt[board] : guesses.size();
+    for (std::size_t g = 0; g < end; ++g)
+    {
+        tries.push_back(tries.back());
+        tries.back().Apply(guesses[g], patterns[g][board]);
+    }
+}
+
+uint32_t Battle::Boards() const
+{
+    return boards;
+}
+
+uint32_t Battle::MaxTries() const
+{
+    return config.maxTries + boards - 1;
+}
+
+std::size_t Battle::Guesses() const
+{
+    return guesses.size();
+}
+
+bool Battle::Solved(uint32_t board) const
+{
+    return solvedAt[board] != 0;
+}
+
+std::string Battle::Answer(uint32_t board) const
+{
+    return std::string(config.words[answerIndices[board]]);
+}
+
+unsigned int Battle::Score() const
+{
+    unsigned int score = 0;
+    for (uint32_t b = 0; b < boards; ++b)
+        if (solvedAt[b] != 0)
+            score += computeScore(std::max<int>(1, solvedAt[b] - (boards - 1)));
+    return score;
+}
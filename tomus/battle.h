@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "tomus.h"
+
+// Battle mode: several hidden words sharing a length and a first letter
+// played at once, every guess scoring on all the boards. Board state is kept
+// as structure of arrays (answers, solving guess, one pattern row per guess)
+// so a guess is one ComputeFeedbacks pass over the answers, whatever the
+// number of boards; Try rows are only built for drawing.
+struct Battle
+{
+    static constexpr uint32_t kMaxBoards = 16;
+
+    Battle(const Config& c, uint64_t seed);
+
+    // Draw the answers of a new round, false when no length and first letter
+    // have that many solution words
+    bool NewRound(uint32_t boards);
+
+    // As Tomus::Input, for all the boards: WIN once every board is solved,
+    // LOSE when out of tries (maxTries plus one per extra board)
+    InputResult Input(const std::string& input);
+
+    // Rows of a board as Tomus::Tries would give them, up to its solving guess
+    void Tries(uint32_t board, std::vector<Try>& tries) const;
+
+    uint32_t Boards() const;
+    uint32_t MaxTries() const;
+    std::size_t Guesses() const;
+    bool Solved(uint32_t board) const;
+    std::string Answer(uint32_t board) const;
+
+    // computeScore of each solved board, the extra tries not counted
+    unsigned int Score() const;
+
+    const Config& config;
+private:
+    std::vector<std::vector<uint32_t>> buckets; // Solutions by length and first letter
+    Rng gen;
+
+    uint32_t boards = 0;
+    uint32_t length = 0;
+    alignas(64) std::array<uint64_t, kMaxBoards> answers{};
+    std::array<uint32_t, kMaxBoards> answerIndices{};
+    std::array<uint8_t, kMaxBoards> solvedAt{}; // Guess solving the board, from 1, 0 while unsolved
+
+    std::vector<uint64_t> guesses;
+    std::vector<std::array<Pattern, kMaxBoards>> patterns;
+};
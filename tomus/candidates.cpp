@@ -0,0 +1,160 @@
+#include <algorithm>
+
+#include "candidates.h"
+#include "patterns.h"
+
+constexpr uint32_t kAllLetters = (1u << 26) - 1;
+
+CandidateTracker::CandidateTracker(const Config& c) : config(c)
+{
+    for (uint32_t l = 1; l <= kMaxPackedLength; ++l)
+    {
+        // Sorted codes: words sharing a first letter are contiguous
+        const std::vector<uint64_t> codes = PackedSolutions(config, l);
+        Columns& col = columns[l];
+        col.size = codes.size();
+        col.letters.resize(l * codes.size());
+        for (std::size_t w = 0; w < codes.size(); ++w)
+            for (uint32_t i = 0; i < l; ++i)
+                col.letters[i * col.size + w] = UnpackLetter(codes[w], l, i) - 'a';
+
+        uint32_t w = 0;
+        for (uint32_t letter = 0; letter <= 26; ++letter)
+        {
+            while (w < col.size && col.letters[w] < letter)
+                ++w;
+            col.firstLetter[letter] = w;
+        }
+    }
+}
+
+void CandidateTracker::Reset(PackedWord w)
+{
+    word = w;
+    applied = 1; // tries[0] only holds the forced first letter
+
+    const uint32_t l = w.size();
+    const uint32_t first = w[0] - 'a';
+    const Columns& col = columns[l];
+    begin = col.firstLetter[first];
+    end = col.firstLetter[first + 1];
+    count = end - begin;
+    alive.assign(count, 1);
+    letterCount.resize(count);
+
+    allowed.fill(kAllLetters);
+    allowed[0] = 1u << first;
+    minCount.fill(0);
+    maxCount.fill(l - 1);
+}
+
+void CandidateTracker::Update(std::span<const Try> tries)
+{
+    const PackedWord w = tries[0].word;
+    if (w.size() < 2 || w.size() > kMaxPackedLength)
+    {
+        word = w;
+        count = 0;
+        return;
+    }
+
+    const bool sameGame = (w.bits == word.bits) && tries.size() >= applied &&
+        (applied <= 1 || tries[applied - 1].input.bits == lastInput.bits);
+    if (!sameGame)
+        Reset(w);
+
+    for (; applied < tries.size(); ++applied)
+    {
+        Apply(tries[applied]);
+        lastInput = tries[applied].input;
+    }
+}
+
+void CandidateTracker::Apply(const Try& t)
+{
+    const uint32_t l = word.size();
+    const Columns& col = columns[l];
+    const std::size_t n = end - begin;
+    uint8_t* live = alive.data();
+
+    // Letters scored somewhere in the input (green or yellow), and letters
+    // with a gray copy: the latter have an exact count
+    std::array<uint8_t, 26> found = {};
+    uint32_t guessed = 0, grayed = 0;
+    for (uint32_t i = 1; i < l; ++i)
+    {
+        const uint8_t c = t.input[i] - 'a';
+        const uint8_t* column = col.letters.data() + i * col.size + begin;
+        guessed |= 1u << c;
+
+        // Unscored positions are UNKNOWN in Try, they read as gray
+        if (t.states[i] == State::GOOD_POSITION)
+        {
+            allowed[i] &= 1u << c;
+            for (std::size_t w = 0; w < n; ++w)
+                live[w] &= (column[w] == c);
+        }
+        else
+        {
+            allowed[i] &= ~(1u << c);
+            for (std::size_t w = 0; w < n; ++w)
+                live[w] &= (column[w] != c);
+        }
+
+        if (t.states[i] == State::GOOD_POSITION || t.states[i] == State::IN_WORD)
+            found[c]++;
+        else
+            grayed |= 1u << c;
+    }
+
+    for (uint8_t c = 0; c < 26; ++c)
+    {
+        if (!((guessed >> c) & 1))
+            continue;
+
+        const bool exact = (grayed >> c) & 1;
+        if (found[c] <= minCount[c] && !(exact && found[c] < maxCount[c]))
+            continue; // Nothing new about this letter
+
+        minCount[c] = std::max(minCount[c], found[c]);
+        if (exact)
+            maxCount[c] = std::min(maxCount[c], found[c]);
+        const uint8_t lo = minCount[c], hi = maxCount[c];
+
+        uint8_t* counts = letterCount.data();
+        std::fill(counts, counts + n, 0);
+        for (uint32_t i = 1; i < l; ++i)
+        {
+            const uint8_t* column = col.letters.data() + i * col.size + begin;
+            for (std::size_t w = 0; w < n; ++w)
+                counts[w] += (column[w] == c);
+        }
+        for (std::size_t w = 0; w < n; ++w)
+            live[w] &= (counts[w] >= lo) & (counts[w] <= hi);
+    }
+
+    std::size_t remaining = 0;
+    for (std::size_t w = 0; w < n; ++w)
+        remaining += live[w];
+    count = remaining;
+}
+
+std::size_t CandidateTracker::Count() const
+{
+    return count;
+}
+
+uint32_t CandidateTracker::Allowed(uint32_t i) const
+{
+    return allowed[i];
+}
+
+uint8_t CandidateTracker::MinCount(char letter) const
+{
+    return minCount[letter - 'a'];
+}
+
+uint8_t CandidateTracker::MaxCount(char letter) const
+{
+    return maxCount[letter - 'a'];
+}
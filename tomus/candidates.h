@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "tomus.h"
+
+// Number of solution words still consistent with the tries of the current
+// game, kept up to date as tries come in.
+//
+// Feedback is turned into constraints: a letter bitmask per position (a
+// green allows one letter, any other score forbids the guessed one) and a
+// min/max count per letter over positions 1.., the first letter being
+// forced and not scored. Being consistent with those is the same as giving
+// the same feedback.
+//
+// Solutions are stored per length as columns, one byte per word and
+// position, and grouped by first letter. A try only tightens the constraints
+// it mentions, each one is a byte compare over the columns of the current
+// first letter, anded into an alive mask: loops the compiler vectorises.
+struct CandidateTracker
+{
+    CandidateTracker(const Config& c);
+
+    // Only applies the tries not seen yet, starts over on a new word
+    void Update(std::span<const Try> tries);
+
+    std::size_t Count() const;
+
+    // Letters still possible at position i, bit n for letter 'a' + n
+    uint32_t Allowed(uint32_t i) const;
+    uint8_t MinCount(char letter) const;
+    uint8_t MaxCount(char letter) const;
+
+    const Config& config;
+private:
+    struct Columns
+    {
+        std::size_t size = 0;
+        std::vector<uint8_t> letters;                // letters[position * size + word]
+        std::array<uint32_t, 27> firstLetter = {};  // Words starting with 'a' + n: [firstLetter[n], firstLetter[n + 1])
+    };
+
+    void Reset(PackedWord word);
+    void Apply(const Try& t);
+
+    std::array<Columns, kMaxPackedLength + 1> columns;
+
+    // Current game
+    PackedWord word;
+    PackedWord lastInput;
+    std::size_t applied = 0;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::size_t count = 0;
+    std::vector<uint8_t> alive;     // For words [begin, end), 1 if consistent
+    std::vector<uint8_t> letterCount;
+
+    std::array<uint32_t, kMaxPackedLength> allowed = {};
+    std::array<uint8_t, 26> minCount = {};
+    std::array<uint8_t, 26> maxCount = {};
+};
@@ -1,22 +1,139 @@
+#include <algorithm>
+
+#include <nlohmann/json.hpp>
+
+#include "dictionary.h"
 #include "config.h"
+#include "feedback.h"
+#include "profile.h"
 
 void Config::SetWords(const std::vector<std::string>& wds)
 {
-    for (const auto& w : wds)
+    words.Append(wds);
+    admissibleWords.Insert(wds); // Make sure every solution is admissible
+}
+
+void Config::SetAdmissible(const std::vector<std::string>& wds)
+{
+    admissibleWords.Insert(wds);
+}
+
+bool Config::IsWordAdmissible(std::string_view sv) const
+{
+    TOMUS_PROFILE_SCOPE("Config::IsWordAdmissible");
+    return admissibleWords.Contains(sv);
+}
+
+bool Config::LoadText(const std::string& dicPath, const std::string& admPath)
+{
+    std::ifstream fDic(dicPath);
+    std::ifstream aDic(admPath);
+    if (!fDic || !aDic)
+        return false;
+
+    std::string buffer;
+    std::vector<std::string> wds;
+    while (std::getline(fDic, buffer))
+    {
+        if (buffer.size() > minLength && buffer.size() < maxLength)
+            wds.push_back(buffer);
+    }
+    SetWords(wds);
+
+    wds.resize(0);
+    while (std::getline(aDic, buffer))
     {
-        words.push_back(w);
-        admissibleWords.insert(w); // Make sure every solution is admissible
+        if (buffer.size() >= minLength && buffer.size() <= maxLength)
+            wds.push_back(buffer);
     }
+    SetAdmissible(wds);
+    return true;
 }
 
-void Config::SetAdmissible(const std::vector<std::string>& wds)
+bool LoadConfig(const std::string& path, Config& conf, std::string& error)
 {
-    for (const auto& w : wds)
-        admissibleWords.insert(w);
+    TOMUS_PROFILE_SCOPE("LoadConfig");
+    using json = nlohmann::json;
+
+    std::ifstream file(path);
+    if (!file)
+    {
+        error = "Error, can not load [no file]: " + path;
+        return false;
+    }
+
+    try
+    {
+        json data = json::parse(file);
+
+        conf.minLength = data["minLength"].get<unsigned int>();
+        conf.maxLength = data["maxLength"].get<unsigned int>();
+        conf.maxTries  = data["maxTries"].get<unsigned int>();
+        // Solutions are shorter than maxLength, their feedback patterns hold
+        // at most kMaxFeedbackLength letters
+        if (conf.maxLength > kMaxFeedbackLength + 1)
+        {
+            error = "Error, maxLength can not exceed " + std::to_string(kMaxFeedbackLength + 1) + ": " + path;
+            return false;
+        }
+        conf.maxTime   = data["maxTime"].get<unsigned int>();
+        if (data.contains("seed"))
+            conf.seed = data["seed"].get<uint64_t>();
+        conf.logDir = data.value("logs", "");
+        conf.eventDriven = data.value("eventDriven", false);
+        conf.training = data.value("training", false);
+        conf.daily = data.value("daily", false);
+        conf.dailySeed = data.value("dailySeed", uint64_t(0));
+        conf.battle = std::min(data.value("battle", 0u), 16u);
+        conf.absurd = data.value("absurd", false);
+
+        const std::string selection = data.value("selection", "uniform");
+        if (selection == "uniform")          conf.selection = WordSelection::UNIFORM;
+        else if (selection == "weighted")    conf.selection = WordSelection::WEIGHTED;
+        else if (selection == "progression") conf.selection = WordSelection::PROGRESSION;
+        else
+        {
+            error = "Error, unknown selection: " + selection;
+            return false;
+        }
+        conf.difficultyPath = data.value("difficulty", "res/difficulty.bin");
+        conf.difficultyTarget = data.value("difficultyTarget", 0.5f);
+        conf.progressionWords = std::max(1u, data.value("progressionWords", 30u));
+        
+        const std::string dicPath = data["mots"].get<std::string>();
+        const std::string admPath = data["admissibles"].get<std::string>();
+        const std::string binPath = data.value("dictionary", "");
+
+        // Prefer the precompiled image, the text lists are the fallback
+        const bool loaded = (!binPath.empty() && LoadDictionary(binPath, conf))
+                         || conf.LoadText(dicPath, admPath);
+        if (!loaded)
+        {
+            error = "Errro, can not load dictionnary: " + dicPath;
+            return false;
+        }
+
+        TOMUS_PROFILE_COUNT("words", conf.words.size());
+        TOMUS_PROFILE_COUNT("admissible words", conf.admissibleWords.Size());
+        std::cout << "Loaded: " << conf.words.size() << std::endl;
+        std::cout << "Loaded: " << conf.admissibleWords.Size() << std::endl;
+        return true;
+    }
+    catch(std::exception& ex)
+    {
+        error = "Error, can not load: " + path + "; error = " + ex.what();
+        return false;
+    }
 }
 
-bool Config::IsWordAdmissible(const std::string& sv) const
+Config LoadConfig(const std::string& path)
 {
-    auto it = admissibleWords.find(sv);
-    return it != admissibleWords.end();
+    Config conf;
+    std::string error;
+    if (!LoadConfig(path, conf, error))
+    {
+        std::cerr << error << std::endl;
+        exit(1);
+    }
+    return conf;
 }
@@ -1,11 +1,24 @@
+#pragma once
+
 #include <string_view>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <random>
+#include <optional>
 #include <array>
-#include <set>
+
+#include "wordlist.h"
+#include "lexicon.h"
+
+// How Tomus::NewWord picks the next word, see WordSampler
+enum class WordSelection
+{
+    UNIFORM,
+    WEIGHTED,       // Words near difficultyTarget are the most likely
+    PROGRESSION     // The target rises from 0 to 1 over progressionWords words
+};
 
 struct Config
 {
@@ -14,16 +27,37 @@ struct Config
     
     void SetWords(const std::vector<std::string>& words);
     void SetAdmissible(const std::vector<std::string>& words);
-    bool IsWordAdmissible(const std::string& str) const;
+    bool IsWordAdmissible(std::string_view str) const;
 
-    std::vector<std::string> words;
-    std::set<std::string> admissibleWords;
+    // Read solution and admissible lists, one word per line, keeping
+    // words within [minLength, maxLength]
+    bool LoadText(const std::string& dicPath, const std::string& admPath);
+
+    WordList words;
+    Lexicon admissibleWords;
 
     uint32_t minLength = 5;
     uint32_t maxLength = 8;
     uint32_t maxTries  = 6;
     uint32_t maxTime   = 30 * 60;
+
+    std::optional<uint64_t> seed; // Random when not set
+    std::string logDir;           // Game logs are written there when not empty
+    bool eventDriven = false;     // Redraw only on changes instead of every frame
+    bool training = false;        // Show how many solutions are still possible
+    bool daily = false;           // Play the words of the day instead of random ones
+    uint64_t dailySeed = 0;       // Daily schedule seed, shared by all players
+    uint32_t battle = 0;          // Boards per battle round, 0 for single words
+    bool absurd = false;          // The answer is picked against the player
+
+    WordSelection selection = WordSelection::UNIFORM;
+    std::string difficultyPath;   // Word difficulty sidecar, see DifficultyTable
+    float difficultyTarget = 0.5f;
+    uint32_t progressionWords = 30;
 private:
 };
 
-
+// Read a json config and the dictionaries it references. Fails with a
+// message in error; the second form prints it and exits, for the tools.
+bool LoadConfig(const std::string& path, Config& conf, std::string& error);
+Config LoadConfig(const std::string& path);
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "daily.h"
+#include "parallel.h"
+#include "random.h"
+#include "solver.h"
+
+constexpr char     kDailyMagic[8] = {'T', 'O', 'M', 'U', 'S', 'D', 'A', 'Y'};
+constexpr uint32_t kDailyVersion  = 1;
+
+struct DailyHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t year;
+    uint64_t seed;
+    uint64_t wordsHash;
+    uint32_t wordCount;
+    uint32_t days;
+    uint32_t lengths;
+    uint32_t optimalLengths;    // Bit per word length, 0 in the first files
+};
+
+// Word lengths with an optimal tree, as a bit mask
+static uint32_t OptimalLengths(std::span<const DecisionTree> trees)
+{
+    uint32_t mask = 0;
+    for (std::size_t l = 0; l < std::min<std::size_t>(trees.size(), 32); ++l)
+        if (trees[l].Optimal() && trees[l].Length() == l)
+            mask |= uint32_t(1) << l;
+    return mask;
+}
+
+static bool IsLeapYear(uint32_t year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+uint32_t DailyPuzzleId(uint32_t year, uint32_t day)
+{
+    return year * 1000 + day + 1;
+}
+
+DailySchedule DailySchedule::Build(const Config& conf, uint64_t seed, uint32_t year, std::span<const DecisionTree> trees)
+{
+    const uint32_t optimal = OptimalLengths(trees);
+
+    std::vector<std::vector<uint32_t>> byLength(kMaxPackedLength + 1);
+    for (std::size_t i = 0; i < conf.words.size(); ++i)
+        if (conf.words[i].size() <= kMaxPackedLength)
+            byLength[conf.words[i].size()].push_back(i);
+
+    std::vector<uint32_t> lengthList;
+    for (uint32_t l = 1; l <= kMaxPackedLength; ++l)
+        if (!byLength[l].empty())
+            lengthList.push_back(l);
+
+    const uint32_t days = IsLeapYear(year) ? 366 : 365;
+    const uint32_t lengths = lengthList.size();
+    auto owned = std::make_shared<std::vector<DailyPuzzle>>(std::size_t(days) * lengths);
+
+    for (uint32_t li = 0; li < lengths; ++li)
+    {
+        const uint32_t l = lengthList[li];
+        std::vector<uint32_t>& words = byLength[l];
+
+        // Fisher-Yates with a generator only depending on (seed, year, length)
+        Rng gen(seed ^ (uint64_t(year) << 32) ^ (uint64_t(l) << 56));
+        for (uint32_t i = words.size() - 1; i > 0; --i)
+            std::swap(words[i], words[gen.Below(i + 1)]);
+
+        for (uint32_t d = 0; d < days; ++d)
+            (*owned)[std::size_t(d) * lengths + li] = {words[d % words.size()], (uint8_t)l, 0, 0};
+    }
+
+    // Metadata: play every puzzle with the hint engine, or follow its optimal
+    // tree
+    std::vector<std::unique_ptr<Solver>> solvers;
+    std::vector<std::unique_ptr<Tomus>> games;
+    for (unsigned int w = 0; w < WorkerCount(); ++w)
+    {
+        solvers.push_back(std::make_unique<Solver>(conf, false));
+        games.push_back(std::make_unique<Tomus>(conf, 0));
+    }
+
+    ParallelFor(owned->size(), [&](std::size_t i, unsigned int worker) {
+        DailyPuzzle& p = (*owned)[i];
+        if (p.length < 2 || p.length > kMaxFeedbackLength)
+            return;
+
+        Tomus& tomus = *games[worker];
+        Solver& solver = *solvers[worker];
+        tomus.NewWord(p.word);
+        solver.Update(tomus.Tries());
+        p.candidates = std::min<std::size_t>(solver.Candidates(), UINT16_MAX);
+
+        DecisionReview review;
+        if (((optimal >> p.length) & 1) && trees[p.length].Review(tomus.Tries(), review))
+        {
+            if (!review.line.empty() && review.line.back() == tomus.Tries()[0].word.Code())
+                p.depth = review.line.size();
+            return;
+        }
+
+        // Depth stays 0 when the solver loses within the rules
+        InputResult r = InputResult::VALID;
+        for (uint32_t guesses = 1; r == InputResult::VALID; ++guesses)
+        {
+            const std::string hint = solver.Hint(tomus.Tries());
+            if (hint.empty())
+                break;
+            r = tomus.Input(hint);
+            if (r == InputResult::WIN)
+                p.depth = guesses;
+        }
+    }, 1);
+
+    DailySchedule s;
+    s.seed = seed;
+    s.year = year;
+    s.wordsHash = conf.words.Hash();
+    s.wordCount = conf.words.size();
+    s.days = days;
+    s.lengths = lengths;
+    s.optimalLengths = optimal;
+    s.puzzles = owned->data();
+    s.storage = owned;
+    return s;
+}
+
+DailySchedule DailySchedule::LoadOrBuild(const std::string& path, const Config& conf, uint64_t seed, uint32_t year,
+                                         std::span<const DecisionTree> trees)
+{
+    DailySchedule s;
+    if (s.Load(path, conf, seed, year, trees))
+        return s;
+
+    s = Build(conf, seed, year, trees);
+    if (!s.Save(path))
+        std::cerr << "Warning, can not save daily schedule to: " << path << std::endl;
+    return s;
+}
+
+bool DailySchedule::Save(const std::string& path) const
+{
+    DailyHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kDailyMagic, sizeof(header.magic));
+    header.version   = kDailyVersion;
+    header.year      = year;
+    header.seed      = seed;
+    header.wordsHash = wordsHash;
+    header.wordCount = wordCount;
+    header.days      = days;
+    header.lengths   = lengths;
+    header.optimalLengths = optimalLengths;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(puzzles), std::size_t(days) * lengths * sizeof(DailyPuzzle));
+    return (bool)file;
+}
+
+bool DailySchedule::Load(const std::string& path, const Config& conf, uint64_t s, uint32_t y, std::span<const DecisionTree> trees)
+{
+    auto file = MappedFile::Open(path);
+    if (!file || file->size < sizeof(DailyHeader))
+        return false;
+
+    DailyHeader header;
+    std::memcpy(&header, file->data, sizeof(header));
+    if (std::memcmp(header.magic, kDailyMagic, sizeof(header.magic)) != 0 || header.version != kDailyVersion)
+        return false;
+    if (header.year != y || header.seed != s || header.wordCount != conf.words.size())
+        return false;
+    if (file->size != sizeof(DailyHeader) + std::size_t(header.days) * header.lengths * sizeof(DailyPuzzle))
+        return false;
+    // Depths can be made optimal since the file was written
+    if (OptimalLengths(trees) & ~header.optimalLengths)
+        return false;
+    // Hashing the list is the slow part of the checks, it comes last
+    if (header.wordsHash != conf.words.Hash())
+        return false;
+
+    seed = s;
+    year = y;
+    wordsHash = header.wordsHash;
+    wordCount = header.wordCount;
+    days = header.days;
+    lengths = header.lengths;
+    optimalLengths = header.optimalLengths;
+    puzzles = reinterpret_cast<const DailyPuzzle*>(file->data + sizeof(DailyHeader));
+    storage = file;
+    return true;
+}
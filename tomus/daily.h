@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "decision.h"
+#include "dictionary.h"
+
+// One daily word and what is known about it
+struct DailyPuzzle
+{
+    uint32_t word;          // Index in Config::words
+    uint8_t length;
+    uint8_t depth;          // Guesses to solve it, 0 if lost (see DailySchedule::OptimalDepth)
+    uint16_t candidates;    // Solutions sharing its length and first letter
+};
+
+// Daily words for a whole year, the same for everyone using the same seed
+// and word list: for each solution length, the words of that length are
+// shuffled with a generator seeded from (seed, year, length) and day d plays
+// the d-th one, so no word comes back within a year unless the length has
+// fewer words than days.
+//
+// The schedule and its metadata are cached in a small file, mapped at
+// startup: a day is then an O(1) lookup. The file is rebuilt when it was
+// made for another seed, year or word list, or without an optimal decision
+// tree available since.
+struct DailySchedule
+{
+    DailySchedule()
+    {}
+
+    // Compute the schedule and solve every puzzle, over all cores. Trees are
+    // indexed by word length (see tomus_decision): the depth of a puzzle is
+    // read from the optimal tree of its length when there is one, and is the
+    // number of guesses of the entropy solver otherwise (an upper bound).
+    static DailySchedule Build(const Config& conf, uint64_t seed, uint32_t year, std::span<const DecisionTree> trees = {});
+    static DailySchedule LoadOrBuild(const std::string& path, const Config& conf, uint64_t seed, uint32_t year,
+                                     std::span<const DecisionTree> trees = {});
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path, const Config& conf, uint64_t seed, uint32_t year, std::span<const DecisionTree> trees = {});
+
+    // Puzzles of a day of the year (0 for the 1st of January), shortest first
+    std::span<const DailyPuzzle> Day(uint32_t day) const
+    {
+        return std::span<const DailyPuzzle>(puzzles + std::size_t(day % std::max(days, 1u)) * lengths, lengths);
+    }
+
+    uint32_t Days() const
+    {
+        return days;
+    }
+
+    // Whether the depths of a word length are optimal, or solver upper bounds
+    bool OptimalDepth(uint32_t length) const
+    {
+        return length < 32 && (optimalLengths >> length) & 1;
+    }
+private:
+    uint64_t seed = 0;
+    uint64_t wordsHash = 0;
+    uint32_t wordCount = 0;
+    uint32_t year = 0;
+    uint32_t days = 0;
+    uint32_t lengths = 0;
+    uint32_t optimalLengths = 0; // Bit per word length
+
+    std::shared_ptr<const void> storage;
+    const DailyPuzzle* puzzles = nullptr;
+};
+
+// Leaderboard puzzle id of a day: entries with the same id played the same words
+uint32_t DailyPuzzleId(uint32_t year, uint32_t day);
@@ -0,0 +1,540 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+#include "decision.h"
+#include "dictionary.h"
+#include "parallel.h"
+#include "random.h"
+
+constexpr char     kDecisionMagic[8] = {'T', 'O', 'M', 'U', 'S', 'T', 'R', 'E'};
+constexpr uint32_t kDecisionVersion  = 1;
+
+constexpr uint32_t kNoNode   = ~uint32_t(0);
+constexpr uint32_t kNoGuess  = ~uint32_t(0);
+constexpr uint32_t kInfinite = ~uint32_t(0) / 2;
+
+struct DecisionHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t length;
+    uint32_t maxTries;
+    uint32_t beam;
+    uint64_t guessHash;
+    uint64_t answersHash;
+    uint32_t roots[26];
+    uint32_t costs[26];
+    uint32_t nodeCount;
+    uint32_t childCount;
+    uint64_t fileSize;
+};
+
+struct OwnedDecision
+{
+    std::vector<DecisionNode> nodes;
+    std::vector<DecisionChild> children;
+};
+
+// Guesses spent on n answers with tries left, at best: one found at once,
+// the others with a second guess. Lost answers only count their penalty.
+static uint32_t LowerBound(uint32_t n, uint32_t tries)
+{
+    if (n == 0)
+        return 0;
+    return tries == 0 ? n : 2 * n - 1;
+}
+
+// Search of the tree of one first letter. Candidate sets hold answer indices
+// in the block, guesses are matrix guess indices.
+struct TreeSearch
+{
+    struct Entry
+    {
+        uint32_t cost;
+        uint32_t guess;
+        bool exact;     // Otherwise cost is a lower bound
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, Entry> entries;
+    };
+
+    struct Scratch
+    {
+        std::vector<uint32_t> counts;
+        std::vector<Pattern> used;
+        std::vector<std::pair<uint64_t, uint32_t>> ranked;
+    };
+
+    struct Class
+    {
+        Pattern pattern;
+        uint32_t begin;
+        uint32_t size;
+    };
+
+    static constexpr std::size_t kShards = 64;
+
+    TreeSearch(const PatternMatrix& m, uint32_t letter, uint32_t b) :
+        matrix(m), block(m.LetterBlock(letter)), beam(b), scratch(WorkerCount())
+    {
+        Rng gen(0x7472656573ull + letter);
+        const auto guesses = matrix.Guesses().subspan(block.guessBegin, block.guessCount);
+        for (uint32_t a = 0; a < block.answerCount; ++a)
+        {
+            keys.push_back(gen());
+
+            const uint64_t code = matrix.Answers()[block.answerBegin + a];
+            const auto it = std::lower_bound(guesses.begin(), guesses.end(), code);
+            answerGuess.push_back(it != guesses.end() && *it == code ? block.guessBegin + (it - guesses.begin()) : kNoGuess);
+        }
+        for (Scratch& s : scratch)
+            s.counts.assign(PatternCount(matrix.Length()), 0);
+    }
+
+    uint64_t Key(std::span<const uint32_t> set, uint32_t tries) const
+    {
+        uint64_t h = tries * 0x9e3779b97f4a7c15ull;
+        for (const uint32_t a : set)
+            h += keys[a];
+        return h;
+    }
+
+    bool Lookup(uint64_t key, Entry& entry)
+    {
+        Shard& shard = memo[key % kShards];
+        std::lock_guard lock(shard.mutex);
+        const auto it = shard.entries.find(key);
+        if (it == shard.entries.end())
+            return false;
+        entry = it->second;
+        return true;
+    }
+
+    // Exact results are final, bounds only grow
+    void Store(uint64_t key, const Entry& entry)
+    {
+        Shard& shard = memo[key % kShards];
+        std::lock_guard lock(shard.mutex);
+        const auto [it, inserted] = shard.entries.try_emplace(key, entry);
+        if (!inserted && !it->second.exact && (entry.exact || entry.cost > it->second.cost))
+            it->second = entry;
+    }
+
+    // Sets solved by guessing one of their answers: a single answer, two
+    // answers, or the last try
+    bool Trivial(std::span<const uint32_t> set, uint32_t tries, uint32_t& cost, uint32_t& guess) const
+    {
+        if (set.empty() || tries == 0)
+        {
+            cost = set.size();
+            guess = kNoGuess;
+            return true;
+        }
+        if (set.size() > 2 && tries > 1)
+            return false;
+
+        // Before the last try, the other answer must be admissible too
+        guess = kNoGuess;
+        for (const uint32_t a : set)
+        {
+            if (answerGuess[a] == kNoGuess && tries > 1)
+                return false;
+            if (guess == kNoGuess)
+                guess = answerGuess[a];
+        }
+        cost = LowerBound(set.size(), tries);
+        return guess != kNoGuess;
+    }
+
+    // Classes of the set by the pattern of guess, sorted into sorted
+    std::vector<Class> Split(uint32_t guess, std::span<const uint32_t> set, std::vector<uint32_t>& sorted, unsigned int worker)
+    {
+        Scratch& s = scratch[worker];
+        const Pattern* row = matrix.Row(guess);
+        for (const uint32_t a : set)
+            if (s.counts[row[a]]++ == 0)
+                s.used.push_back(row[a]);
+
+        std::sort(s.used.begin(), s.used.end());
+        std::vector<Class> classes;
+        uint32_t begin = 0;
+        for (const Pattern p : s.used)
+        {
+            classes.push_back({p, begin, 0});
+            begin += s.counts[p];
+            s.counts[p] = classes.size() - 1;
+        }
+
+        sorted.resize(set.size());
+        for (const uint32_t a : set)
+        {
+            Class& c = classes[s.counts[row[a]]];
+            sorted[c.begin + c.size++] = a;
+        }
+
+        for (const Pattern p : s.used)
+            s.counts[p] = 0;
+        s.used.clear();
+        return classes;
+    }
+
+    // Guesses splitting the set, smallest sum of squared class sizes first
+    // (the win class left out), at most limit of them unless 0
+    std::vector<uint32_t> Rank(std::span<const uint32_t> set, uint32_t limit, unsigned int worker)
+    {
+        Scratch& s = scratch[worker];
+        s.ranked.clear();
+        for (uint32_t g = block.guessBegin; g < block.guessBegin + block.guessCount; ++g)
+        {
+            const Pattern* row = matrix.Row(g);
+            for (const uint32_t a : set)
+                if (s.counts[row[a]]++ == 0)
+                    s.used.push_back(row[a]);
+
+            uint64_t score = 0;
+            for (const Pattern p : s.used)
+            {
+                if (p != kWinPattern)
+                    score += uint64_t(s.counts[p]) * s.counts[p];
+                s.counts[p] = 0;
+            }
+            if (s.used.size() > 1 || s.used[0] == kWinPattern)
+                s.ranked.push_back({score, g});
+            s.used.clear();
+        }
+
+        const std::size_t n = limit == 0 ? s.ranked.size() : std::min<std::size_t>(limit, s.ranked.size());
+        std::partial_sort(s.ranked.begin(), s.ranked.begin() + n, s.ranked.end());
+
+        std::vector<uint32_t> guesses;
+        for (std::size_t i = 0; i < n; ++i)
+            guesses.push_back(s.ranked[i].second);
+        return guesses;
+    }
+
+    // Guesses spent on the set when guess is played first, at least bound
+    // when it can not do better than bound
+    uint32_t Evaluate(uint32_t guess, std::span<const uint32_t> set, uint32_t tries, uint32_t bound, unsigned int worker)
+    {
+        std::vector<uint32_t> sorted;
+        std::vector<Class> classes = Split(guess, set, sorted, worker);
+        std::erase_if(classes, [](const Class& c) { return c.pattern == kWinPattern; });
+        std::sort(classes.begin(), classes.end(), [](const Class& a, const Class& b) {
+            return a.size != b.size ? a.size > b.size : a.pattern < b.pattern;
+        });
+
+        uint32_t total = set.size(), bounds = 0;
+        for (const Class& c : classes)
+            bounds += LowerBound(c.size, tries - 1);
+
+        for (const Class& c : classes)
+        {
+            if (total + bounds >= bound)
+                break;
+            bounds -= LowerBound(c.size, tries - 1);
+            const auto sub = std::span<const uint32_t>(sorted).subspan(c.begin, c.size);
+            total += Solve(sub, tries - 1, bound - total - bounds, worker);
+        }
+        return total + bounds;
+    }
+
+    // Fewest guesses spent on the set, at least bound when it can not do
+    // better than bound
+    uint32_t Solve(std::span<const uint32_t> set, uint32_t tries, uint32_t bound, unsigned int worker)
+    {
+        uint32_t cost, guess;
+        if (Trivial(set, tries, cost, guess))
+            return cost;
+
+        uint32_t lower = LowerBound(set.size(), tries);
+        if (lower >= bound)
+            return lower;
+
+        const uint64_t key = Key(set, tries);
+        Entry entry;
+        if (Lookup(key, entry))
+        {
+            if (entry.exact || entry.cost >= bound)
+                return entry.cost;
+            lower = std::max(lower, entry.cost);
+        }
+
+        const auto guesses = Rank(set, beam, worker);
+        if (guesses.empty())
+        {
+            // Nothing tells the answers apart, all of them are lost
+            cost = set.size() * (tries + 1);
+            Store(key, {cost, kNoGuess, true});
+            return cost;
+        }
+
+        uint32_t best = bound, bestGuess = kNoGuess;
+        for (const uint32_t g : guesses)
+        {
+            const uint32_t c = Evaluate(g, set, tries, best, worker);
+            if (c < best)
+            {
+                best = c;
+                bestGuess = g;
+                if (best <= lower)
+                    break;
+            }
+        }
+
+        Store(key, {best, bestGuess, bestGuess != kNoGuess});
+        return best;
+    }
+
+    // Root guesses over all cores, twice the beam of the other nodes. Ties are
+    // searched to the end so that the first ranked guess wins them whatever
+    // the order the workers finish in.
+    uint32_t Root(std::span<const uint32_t> set, uint32_t tries)
+    {
+        uint32_t cost, guess;
+        if (Trivial(set, tries, cost, guess))
+            return cost;
+
+        const auto guesses = Rank(set, 2 * beam, 0);
+        if (guesses.empty())
+            return Solve(set, tries, kInfinite, 0);
+
+        std::mutex mutex;
+        std::atomic<uint32_t> bound = kInfinite;
+        uint32_t best = kInfinite;
+        std::size_t bestRank = guesses.size();
+        ParallelFor(guesses.size(), [&](std::size_t i, unsigned int worker) {
+            const uint32_t c = Evaluate(guesses[i], set, tries, bound.load() + 1, worker);
+            std::lock_guard lock(mutex);
+            if (c < best || (c == best && i < bestRank))
+            {
+                best = c;
+                bestRank = i;
+                bound = best;
+            }
+        }, 1);
+
+        Store(Key(set, tries), {best, guesses[bestRank], true});
+        return best;
+    }
+
+    // Append the nodes of the set, its node first. kNoNode when the search
+    // left no exact result for a set, the nodes appended are then garbage.
+    uint32_t Emit(std::span<const uint32_t> set, uint32_t tries, OwnedDecision& out)
+    {
+        uint32_t cost, guess;
+        if (!Trivial(set, tries, cost, guess))
+        {
+            const uint64_t key = Key(set, tries);
+            Entry entry{};
+            if (!Lookup(key, entry) || !entry.exact)
+            {
+                Solve(set, tries, kInfinite, 0);
+                if (!Lookup(key, entry) || !entry.exact)
+                    return kNoNode;
+            }
+            guess = entry.guess;
+        }
+
+        const uint32_t node = out.nodes.size();
+        out.nodes.push_back({0, 0, 0, (uint16_t)std::min<std::size_t>(set.size(), UINT16_MAX)});
+        if (guess == kNoGuess)
+        {
+            // Any word, the answers are lost anyway
+            out.nodes[node].guess = matrix.Guesses()[block.guessBegin];
+            return node;
+        }
+        out.nodes[node].guess = matrix.Guesses()[guess];
+        if (tries == 1)
+            return node;
+
+        std::vector<uint32_t> sorted;
+        std::vector<Class> classes = Split(guess, set, sorted, 0);
+        std::erase_if(classes, [](const Class& c) { return c.pattern == kWinPattern; });
+
+        const uint32_t first = out.children.size();
+        out.nodes[node].firstChild = first;
+        out.nodes[node].childCount = classes.size();
+        out.children.resize(first + classes.size());
+        for (std::size_t i = 0; i < classes.size(); ++i)
+        {
+            const auto sub = std::span<const uint32_t>(sorted).subspan(classes[i].begin, classes[i].size);
+            const uint32_t child = Emit(sub, tries - 1, out);
+            if (child == kNoNode)
+                return kNoNode;
+            out.children[first + i] = {classes[i].pattern, 0, child};
+        }
+        return node;
+    }
+
+    const PatternMatrix& matrix;
+    const PatternMatrix::Block& block;
+    const uint32_t beam;
+
+    std::vector<uint64_t> keys;         // Random key of each answer
+    std::vector<uint32_t> answerGuess;  // Guess index of each answer, kNoGuess when not admissible
+    std::vector<Scratch> scratch;       // By ParallelFor worker
+    std::array<Shard, kShards> memo;
+};
+
+DecisionTree DecisionTree::Build(const PatternMatrix& matrix, const Config& conf, uint32_t beam)
+{
+    auto owned = std::make_shared<OwnedDecision>();
+
+    DecisionTree t;
+    t.length = matrix.Length();
+    t.maxTries = conf.maxTries;
+    t.beam = beam;
+    t.guessHash = HashCodes(conf.admissibleWords.Bucket(t.length));
+    t.answersHash = HashCodes(matrix.Answers());
+    for (uint32_t letter = 0; letter < 26; ++letter)
+    {
+        const PatternMatrix::Block& block = matrix.LetterBlock(letter);
+        t.roots[letter] = kNoNode;
+        if (block.answerCount == 0 || block.guessCount == 0 || conf.maxTries == 0)
+            continue;
+
+        std::vector<uint32_t> set(block.answerCount);
+        for (uint32_t a = 0; a < block.answerCount; ++a)
+            set[a] = a;
+
+        TreeSearch search(matrix, letter, beam);
+        t.costs[letter] = search.Root(set, conf.maxTries);
+        const std::size_t nodes = owned->nodes.size(), children = owned->children.size();
+        t.roots[letter] = search.Emit(set, conf.maxTries, *owned);
+        if (t.roots[letter] == kNoNode)
+        {
+            std::cerr << "Error, incomplete decision tree search, length " << t.length
+                      << ", letter " << char('a' + letter) << std::endl;
+            owned->nodes.resize(nodes);
+            owned->children.resize(children);
+            t.costs[letter] = 0;
+        }
+    }
+
+    t.nodeCount = owned->nodes.size();
+    t.childCount = owned->children.size();
+    t.nodes = owned->nodes.data();
+    t.children = owned->children.data();
+    t.storage = owned;
+    return t;
+}
+
+bool DecisionTree::Save(const std::string& path) const
+{
+    DecisionHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kDecisionMagic, sizeof(header.magic));
+    header.version     = kDecisionVersion;
+    header.length      = length;
+    header.maxTries    = maxTries;
+    header.beam        = beam;
+    header.guessHash   = guessHash;
+    header.answersHash = answersHash;
+    std::copy(roots.begin(), roots.end(), header.roots);
+    std::copy(costs.begin(), costs.end(), header.costs);
+    header.nodeCount   = nodeCount;
+    header.childCount  = childCount;
+    header.fileSize    = sizeof(DecisionHeader) + std::size_t(nodeCount) * sizeof(DecisionNode) + std::size_t(childCount) * sizeof(DecisionChild);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(nodes), std::size_t(nodeCount) * sizeof(DecisionNode));
+    file.write(reinterpret_cast<const char*>(children), std::size_t(childCount) * sizeof(DecisionChild));
+    return (bool)file;
+}
+
+bool DecisionTree::Load(const std::string& path, const Config& conf, uint32_t l)
+{
+    auto file = MappedFile::Open(path);
+    if (!file || file->size < sizeof(DecisionHeader))
+        return false;
+
+    DecisionHeader header;
+    std::memcpy(&header, file->data, sizeof(header));
+    if (std::memcmp(header.magic, kDecisionMagic, sizeof(header.magic)) != 0 || header.version != kDecisionVersion)
+        return false;
+    if (header.length != l || header.maxTries != conf.maxTries)
+        return false;
+    const std::size_t nodesSize = std::size_t(header.nodeCount) * sizeof(DecisionNode);
+    if (header.fileSize != file->size || file->size != sizeof(DecisionHeader) + nodesSize + std::size_t(header.childCount) * sizeof(DecisionChild))
+        return false;
+
+    // Only use trees built from the very same lists
+    if (header.guessHash != HashCodes(conf.admissibleWords.Bucket(l)) || header.answersHash != HashCodes(PackedSolutions(conf, l)))
+        return false;
+
+    // Reviews follow the links without checking them
+    const auto* n = reinterpret_cast<const DecisionNode*>(file->data + sizeof(DecisionHeader));
+    const auto* c = reinterpret_cast<const DecisionChild*>(file->data + sizeof(DecisionHeader) + nodesSize);
+    for (uint32_t i = 0; i < header.nodeCount; ++i)
+        if (std::size_t(n[i].firstChild) + n[i].childCount > header.childCount)
+            return false;
+    for (uint32_t i = 0; i < header.childCount; ++i)
+        if (c[i].node >= header.nodeCount)
+            return false;
+    for (const uint32_t r : header.roots)
+        if (r != kNoNode && r >= header.nodeCount)
+            return false;
+
+    length = header.length;
+    maxTries = header.maxTries;
+    beam = header.beam;
+    guessHash = header.guessHash;
+    answersHash = header.answersHash;
+    std::copy(std::begin(header.roots), std::end(header.roots), roots.begin());
+    std::copy(std::begin(header.costs), std::end(header.costs), costs.begin());
+    nodeCount = header.nodeCount;
+    childCount = header.childCount;
+    nodes = n;
+    children = c;
+    storage = file;
+    return true;
+}
+
+bool DecisionTree::Review(std::span<const Try> tries, DecisionReview& review) const
+{
+    if (tries.empty() || tries[0].word.size() != length || nodeCount == 0)
+        return false;
+
+    const uint64_t answer = tries[0].word.Code();
+    const uint32_t letter = answer >> (kLetterBits * (length - 1));
+    if (roots[letter] == kNoNode)
+        return false;
+
+    review = {};
+    review.expected = costs[letter] / double(nodes[roots[letter]].candidates);
+
+    // A line never outgrows the tries, whatever the file holds
+    uint32_t node = roots[letter];
+    while (review.line.size() < maxTries)
+    {
+        const DecisionNode& n = nodes[node];
+        review.line.push_back(n.guess);
+        if (n.guess == answer)
+            break;
+
+        const Pattern p = ComputeFeedback(n.guess, answer, length);
+        const DecisionChild* begin = children + n.firstChild;
+        const DecisionChild* end = begin + n.childCount;
+        const DecisionChild* it = std::lower_bound(begin, end, p, [](const DecisionChild& c, Pattern p) { return c.pattern < p; });
+        if (it == end || it->pattern != p)
+            break;
+        node = it->node;
+    }
+
+    // The initial try is not a guess
+    while (review.followed + 1 < tries.size() && review.followed < review.line.size()
+           && tries[review.followed + 1].input.Code() == review.line[review.followed])
+        review.followed++;
+    return true;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "patterns.h"
+#include "tomus.h"
+
+struct DecisionNode
+{
+    uint64_t guess;         // Packed
+    uint32_t firstChild;    // In the children array
+    uint16_t childCount;    // Sorted by pattern, none for the win
+    uint16_t candidates;    // Answers still possible before the guess
+};
+
+struct DecisionChild
+{
+    Pattern pattern;
+    uint16_t padding;
+    uint32_t node;
+};
+
+// What the tree would have played for one answer, against what was played
+struct DecisionReview
+{
+    std::vector<uint64_t> line; // Tree guesses, packed, ending with the answer unless lost
+    std::size_t followed = 0;   // Leading guesses of the player equal to the line
+    double expected = 0.;       // Mean guesses of the tree over the answers of that first letter
+};
+
+// Guessing strategy of one word length, one tree per first letter: the node
+// guess is played, its feedback picks the child. Built offline by
+// tomus_decision from the pattern matrix and saved as a sidecar file that
+// the game maps to review finished words.
+//
+// The search minimises the total number of guesses over the answers (a lost
+// answer counts maxTries + 1) by depth first branch and bound: each node
+// tries the guesses splitting its candidates, smallest classes (sum of
+// squared sizes) first. A beam of 0 tries all of them and gives the optimal
+// tree, otherwise only the beam best are (twice that at the roots), for lists
+// too large to search exhaustively. Classes are solved largest first and cut
+// as soon as the guesses spent plus 2n - 1 per class left (one answer found
+// at once, the others needing two guesses) can not beat the best guess so
+// far. Results are memoised by candidate set and tries left, sets being
+// hashed as a sum of random keys per answer; cut searches are kept as lower
+// bounds. The root guesses of each letter are searched over all cores,
+// sharing the best cost found so far.
+struct DecisionTree
+{
+    static constexpr uint32_t kDefaultBeam = 0;
+
+    DecisionTree()
+    {}
+
+    static DecisionTree Build(const PatternMatrix& matrix, const Config& conf, uint32_t beam = kDefaultBeam);
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path, const Config& conf, uint32_t length);
+
+    bool Empty() const
+    {
+        return nodeCount == 0;
+    }
+
+    // Built with a beam of 0, every line is then optimal
+    bool Optimal() const
+    {
+        return nodeCount != 0 && beam == 0;
+    }
+
+    uint32_t Length() const
+    {
+        return length;
+    }
+
+    // Total guesses of the tree over the answers of a first letter (lost
+    // answers counting maxTries + 1), and the number of these answers
+    uint32_t Cost(uint32_t letter) const
+    {
+        return costs[letter];
+    }
+
+    uint32_t Answers(uint32_t letter) const
+    {
+        return roots[letter] < nodeCount ? nodes[roots[letter]].candidates : 0;
+    }
+
+    // Tree line of the word played by tries (initial try first, as in
+    // Tomus::History), false when the tree does not cover its length or letter
+    bool Review(std::span<const Try> tries, DecisionReview& review) const;
+private:
+    uint32_t length = 0;
+    uint32_t maxTries = 0;
+    uint32_t beam = 0;
+    uint64_t guessHash = 0;
+    uint64_t answersHash = 0;
+    std::array<uint32_t, 26> roots{};
+    std::array<uint32_t, 26> costs{};
+
+    std::shared_ptr<const void> storage;
+    const DecisionNode* nodes = nullptr;
+    const DecisionChild* children = nullptr;
+    uint32_t nodeCount = 0;
+    uint32_t childCount = 0;
+};
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "dictionary.h"
+
+static std::size_t AlignUp(std::size_t v)
+{
+    return (v + 7) & ~std::size_t(7);
+}
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string& path)
+{
+    auto file = std::make_shared<MappedFile>();
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return nullptr;
+
+    file->size = in.tellg();
+    file->buffer = std::make_unique<std::byte[]>(file->size);
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(file->buffer.get()), file->size))
+        return nullptr;
+    file->data = file->buffer.get();
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED)
+        return nullptr;
+
+    file->data = static_cast<const std::byte*>(ptr);
+    file->size = st.st_size;
+    file->mapped = true;
+#endif
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (mapped)
+        munmap(const_cast<std::byte*>(data), size);
+#endif
+}
+
+bool SaveDictionary(const std::string& path, const Config& conf)
+{
+    DictionaryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kDictionaryMagic, sizeof(header.magic));
+    header.version   = kDictionaryVersion;
+    header.minLength = conf.minLength;
+    header.maxLength = conf.maxLength;
+    header.wordCount = conf.words.size();
+
+    std::size_t codeCount = 0;
+    for (uint32_t l = 0; l <= kMaxPackedLength; ++l)
+    {
+        header.bucketCounts[l] = conf.admissibleWords.Bucket(l).size();
+        codeCount += header.bucketCounts[l];
+    }
+
+    const std::size_t charCount = conf.words.size() > 0 ? conf.words.Offsets()[conf.words.size()] : 0;
+    header.codesOffset   = AlignUp(sizeof(DictionaryHeader));
+    header.offsetsOffset = AlignUp(header.codesOffset + codeCount * sizeof(uint64_t));
+    header.charsOffset   = AlignUp(header.offsetsOffset + (conf.words.size() + 1) * sizeof(uint32_t));
+    header.fileSize      = header.charsOffset + charCount;
+
+    std::vector<std::byte> image(header.fileSize);
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    std::byte* codes = image.data() + header.codesOffset;
+    for (uint32_t l = 0; l <= kMaxPackedLength; ++l)
+    {
+        const auto bucket = conf.admissibleWords.Bucket(l);
+        std::memcpy(codes, bucket.data(), bucket.size_bytes());
+        codes += bucket.size_bytes();
+    }
+
+    if (conf.words.size() > 0)
+    {
+        std::memcpy(image.data() + header.offsetsOffset, conf.words.Offsets(), (conf.words.size() + 1) * sizeof(uint32_t));
+        std::memcpy(image.data() + header.charsOffset, conf.words.Chars(), charCount);
+    }
+    else
+    {
+        std::memset(image.data() + header.offsetsOffset, 0, sizeof(uint32_t));
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    file.write(reinterpret_cast<const char*>(image.data()), image.size());
+    return (bool)file;
+}
+
+bool LoadDictionary(const std::string& path, Config& conf)
+{
+    auto file = MappedFile::Open(path);
+    if (!file || file->size < sizeof(DictionaryHeader))
+        return false;
+
+    DictionaryHeader header;
+    std::memcpy(&header, file->data, sizeof(header));
+    if (std::memcmp(header.magic, kDictionaryMagic, sizeof(header.magic)) != 0)
+        return false;
+    if (header.version != kDictionaryVersion)
+        return false;
+    if (header.minLength != conf.minLength || header.maxLength != conf.maxLength)
+        return false;
+    if (header.fileSize != file->size)
+        return false;
+
+    // Sections in order within the file, sizes checked without overflowing
+    Lexicon::Counts counts;
+    uint64_t codeCount = 0;
+    for (uint32_t l = 0; l <= kMaxPackedLength; ++l)
+    {
+        if (header.bucketCounts[l] > header.fileSize / sizeof(uint64_t))
+            return false;
+        counts[l] = header.bucketCounts[l];
+        codeCount += counts[l];
+    }
+
+    const uint64_t offsetCount = uint64_t(header.wordCount) + 1;
+    if (header.charsOffset > header.fileSize || header.offsetsOffset > header.charsOffset || header.codesOffset > header.offsetsOffset)
+        return false;
+    if (header.codesOffset % 8 != 0 || codeCount > (header.offsetsOffset - header.codesOffset) / sizeof(uint64_t))
+        return false;
+    if (header.offsetsOffset % 4 != 0 || offsetCount > (header.charsOffset - header.offsetsOffset) / sizeof(uint32_t))
+        return false;
+
+    const auto* codes   = reinterpret_cast<const uint64_t*>(file->data + header.codesOffset);
+    const auto* offsets = reinterpret_cast<const uint32_t*>(file->data + header.offsetsOffset);
+    const auto* chars   = reinterpret_cast<const char*>(file->data + header.charsOffset);
+    if (!std::is_sorted(offsets, offsets + offsetCount) || offsets[header.wordCount] > header.fileSize - header.charsOffset)
+        return false;
+
+    conf.words = WordList(file, chars, offsets, header.wordCount);
+    conf.admissibleWords = Lexicon(file, codes, counts);
+    return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "config.h"
+
+// Precompiled dictionary image, built offline by tomus_dictc from the text
+// lists. Layout (all little endian, 8 bytes aligned sections):
+//
+//   DictionaryHeader
+//   uint64_t codes[]          admissible words, packed, one sorted bucket per length
+//   uint32_t offsets[n + 1]   solution words offsets into chars
+//   char     chars[]          solution words, concatenated
+//
+// Loading maps the file and points Config straight into the mapping.
+constexpr char     kDictionaryMagic[8] = {'T', 'O', 'M', 'U', 'S', 'D', 'I', 'C'};
+constexpr uint32_t kDictionaryVersion  = 1;
+
+struct DictionaryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t minLength;
+    uint32_t maxLength;
+    uint32_t wordCount;
+    uint64_t bucketCounts[kMaxPackedLength + 1];
+
+    uint64_t codesOffset;
+    uint64_t offsetsOffset;
+    uint64_t charsOffset;
+    uint64_t fileSize;
+};
+
+// Read-only view of a whole file, memory mapped when the platform allows it
+struct MappedFile
+{
+    static std::shared_ptr<MappedFile> Open(const std::string& path);
+    ~MappedFile();
+
+    const std::byte* data = nullptr;
+    std::size_t size = 0;
+private:
+    bool mapped = false;
+    std::unique_ptr<std::byte[]> buffer;
+};
+
+bool SaveDictionary(const std::string& path, const Config& conf);
+
+// Fill conf words and admissible words from the image. Fails (leaving conf
+// untouched) if the image is missing, corrupted, from another version or was
+// built for other length bounds than conf's.
+bool LoadDictionary(const std::string& path, Config& conf);
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "difficulty.h"
+#include "dictionary.h"
+#include "parallel.h"
+#include "solver.h"
+
+constexpr char     kDifficultyMagic[8] = {'T', 'O', 'M', 'U', 'S', 'D', 'I', 'F'};
+constexpr uint32_t kDifficultyVersion  = 1;
+
+// Weights of the percentile ranks in the difficulty
+constexpr double kGuessesWeight = 0.6;
+constexpr double kRarityWeight  = 0.25;
+constexpr double kRepeatsWeight = 0.15;
+
+struct DifficultyHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint64_t wordsHash;
+    uint32_t maxTries;
+    uint32_t padding;
+};
+
+// Rank of each value in [0, 1], ties sharing the mean of their ranks
+template<typename F>
+static std::vector<double> PercentileRanks(std::size_t n, F&& value)
+{
+    std::vector<uint32_t> order(n);
+    for (std::size_t i = 0; i < n; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return value(a) < value(b); });
+
+    std::vector<double> ranks(n, 0.);
+    for (std::size_t b = 0; b < n;)
+    {
+        std::size_t e = b + 1;
+        while (e < n && value(order[e]) == value(order[b]))
+            ++e;
+        const double rank = n > 1 ? (b + e - 1) / 2. / (n - 1) : 0.;
+        for (std::size_t i = b; i < e; ++i)
+            ranks[order[i]] = rank;
+        b = e;
+    }
+    return ranks;
+}
+
+DifficultyTable DifficultyTable::Build(const Config& conf)
+{
+    const std::size_t n = conf.words.size();
+    auto owned = std::make_shared<std::vector<WordDifficulty>>(n, WordDifficulty{});
+
+    // Letter frequencies of the solutions of each length, first letters
+    // excluded as they are given
+    std::vector<std::array<double, 26>> frequencies(kMaxPackedLength + 1, std::array<double, 26>{});
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const std::string_view w = conf.words[i];
+        if (w.size() <= kMaxPackedLength)
+            for (const char c : w.substr(1))
+                frequencies[w.size()][c - 'a'] += 1.;
+    }
+    for (auto& f : frequencies)
+    {
+        double total = 0.;
+        for (const double c : f)
+            total += c;
+        for (double& c : f)
+            c = total > 0. ? c / total : 0.;
+    }
+
+    std::vector<std::unique_ptr<Solver>> solvers;
+    std::vector<std::unique_ptr<Tomus>> games;
+    for (unsigned int w = 0; w < WorkerCount(); ++w)
+    {
+        solvers.push_back(std::make_unique<Solver>(conf, false));
+        games.push_back(std::make_unique<Tomus>(conf, 0));
+    }
+
+    ParallelFor(n, [&](std::size_t i, unsigned int worker) {
+        WordDifficulty& d = (*owned)[i];
+        const std::string_view w = conf.words[i];
+
+        uint32_t seen = 0;
+        double rarity = 0.;
+        for (std::size_t c = 0; c < w.size(); ++c)
+        {
+            const uint32_t letter = w[c] - 'a';
+            if (seen & (1u << letter))
+                d.repeats++;
+            seen |= 1u << letter;
+            if (c > 0 && w.size() <= kMaxPackedLength)
+                rarity -= std::log2(frequencies[w.size()][letter]);
+        }
+        d.rarity = w.size() > 1 ? rarity / (w.size() - 1) : 0.;
+
+        // Lost words count one guess more than the rules allow
+        d.guesses = conf.maxTries + 1;
+        if (w.size() < 2 || w.size() > kMaxFeedbackLength)
+            return;
+
+        Tomus& tomus = *games[worker];
+        Solver& solver = *solvers[worker];
+        tomus.NewWord(i);
+        InputResult r = InputResult::VALID;
+        for (uint32_t guesses = 1; r == InputResult::VALID; ++guesses)
+        {
+            const std::string hint = solver.Hint(tomus.Tries());
+            if (hint.empty())
+                break;
+            r = tomus.Input(hint);
+            if (r == InputResult::WIN)
+                d.guesses = guesses;
+        }
+    }, 16);
+
+    auto& words = *owned;
+    const auto guesses = PercentileRanks(n, [&](uint32_t i) { return words[i].guesses; });
+    const auto rarity  = PercentileRanks(n, [&](uint32_t i) { return words[i].rarity; });
+    const auto repeats = PercentileRanks(n, [&](uint32_t i) { return words[i].repeats; });
+    for (std::size_t i = 0; i < n; ++i)
+        words[i].difficulty = kGuessesWeight * guesses[i] + kRarityWeight * rarity[i] + kRepeatsWeight * repeats[i];
+
+    DifficultyTable t;
+    t.wordsHash = conf.words.Hash();
+    t.maxTries = conf.maxTries;
+    t.count = n;
+    t.words = owned->data();
+    t.storage = owned;
+    return t;
+}
+
+DifficultyTable DifficultyTable::LoadOrBuild(const std::string& path, const Config& conf)
+{
+    DifficultyTable t;
+    if (t.Load(path, conf))
+        return t;
+
+    t = Build(conf);
+    if (!t.Save(path))
+        std::cerr << "Warning, can not save word difficulties to: " << path << std::endl;
+    return t;
+}
+
+bool DifficultyTable::Save(const std::string& path) const
+{
+    DifficultyHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kDifficultyMagic, sizeof(header.magic));
+    header.version   = kDifficultyVersion;
+    header.count     = count;
+    header.wordsHash = wordsHash;
+    header.maxTries  = maxTries;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(words), std::size_t(count) * sizeof(WordDifficulty));
+    return (bool)file;
+}
+
+bool DifficultyTable::Load(const std::string& path, const Config& conf)
+{
+    auto file = MappedFile::Open(path);
+    if (!file || file->size < sizeof(DifficultyHeader))
+        return false;
+
+    DifficultyHeader header;
+    std::memcpy(&header, file->data, sizeof(header));
+    if (std::memcmp(header.magic, kDifficultyMagic, sizeof(header.magic)) != 0 || header.version != kDifficultyVersion)
+        return false;
+    if (header.count != conf.words.size() || header.maxTries != conf.maxTries)
+        return false;
+    if (file->size != sizeof(DifficultyHeader) + std::size_t(header.count) * sizeof(WordDifficulty))
+        return false;
+    if (header.wordsHash != conf.words.Hash())
+        return false;
+
+    wordsHash = header.wordsHash;
+    maxTries = header.maxTries;
+    count = header.count;
+    words = reinterpret_cast<const WordDifficulty*>(file->data + sizeof(DifficultyHeader));
+    storage = file;
+    return true;
+}
+
+WordSampler::WordSampler(const DifficultyTable& table, const Config& conf) :
+    progressionWords(std::max(1u, conf.progressionWords))
+{
+    const auto words = table.Words();
+    const uint32_t stageCount = conf.selection == WordSelection::PROGRESSION ? kStages : 1;
+
+    std::vector<double> weights(words.size());
+    for (uint32_t s = 0; s < stageCount; ++s)
+    {
+        const double target = stageCount > 1 ? s / double(stageCount - 1) : conf.difficultyTarget;
+        for (std::size_t i = 0; i < words.size(); ++i)
+        {
+            const double x = (words[i].difficulty - target) / kSigma;
+            weights[i] = std::exp(-0.5 * x * x);
+        }
+        stages.emplace_back(weights);
+    }
+}
+
+std::size_t WordSampler::Draw(Rng& gen, std::size_t game) const
+{
+    const std::size_t stage = std::min<std::size_t>(stages.size() - 1, game * stages.size() / progressionWords);
+    return stages[stage](gen);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "random.h"
+
+struct WordDifficulty
+{
+    float difficulty;   // In [0, 1], weighted percentile ranks of the others
+    float rarity;       // Mean -log2 frequency of the letters after the first
+    uint8_t guesses;    // Entropy solver guesses, maxTries + 1 when it loses
+    uint8_t repeats;    // Letters beyond their first occurrence
+    uint16_t padding;
+};
+
+// Difficulty of every solution word, in the order of Config::words. Built
+// offline by tomus_difficulty (every word is played by the solver, over all
+// cores) and saved as a sidecar file, mapped by the game. The file is rebuilt
+// when it was made for another word list or number of tries.
+struct DifficultyTable
+{
+    DifficultyTable()
+    {}
+
+    static DifficultyTable Build(const Config& conf);
+    static DifficultyTable LoadOrBuild(const std::string& path, const Config& conf);
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path, const Config& conf);
+
+    std::span<const WordDifficulty> Words() const
+    {
+        return std::span<const WordDifficulty>(words, count);
+    }
+private:
+    uint64_t wordsHash = 0;
+    uint32_t maxTries = 0;
+    uint32_t count = 0;
+
+    std::shared_ptr<const void> storage;
+    const WordDifficulty* words = nullptr;
+};
+
+// Word draws for Tomus::NewWord following Config::selection. Every word
+// weighs exp(-(difficulty - target)^2 / 2 sigma^2): the target is fixed when
+// weighted, and climbs through kStages steps as the run goes on for a
+// progression, one alias table per step. A draw is O(1) either way.
+struct WordSampler
+{
+    static constexpr uint32_t kStages = 16;
+    static constexpr double kSigma = 0.15;
+
+    WordSampler()
+    {}
+    WordSampler(const DifficultyTable& table, const Config& conf);
+
+    // Index of the next word, game being the number of words already played
+    std::size_t Draw(Rng& gen, std::size_t game) const;
+private:
+    std::vector<AliasTable> stages;
+    uint32_t progressionWords = 1;
+};
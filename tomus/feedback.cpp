@@ -0,0 +1,97 @@
+#include <algorithm>
+
+#include "feedback.h"
+
+// Lowest bit of each of the 12 packed letters
+constexpr uint64_t kLowBits = 0x0084210842108421ull;
+
+// Lowest bit of each 5 bits field of x that is not zero
+static inline uint64_t NonZeroFields(uint64_t x)
+{
+    return (x | (x >> 1) | (x >> 2) | (x >> 3) | (x >> 4)) & kLowBits;
+}
+
+Pattern ComputeFeedback(uint64_t guess, uint64_t answer, uint32_t length)
+{
+    // A position differs when any bit of its 5 bits field differs; fold the
+    // field onto its lowest bit
+    const uint64_t diff = NonZeroFields(guess ^ answer);
+
+    // Letters of the answer not already matched
+    uint8_t counts[32] = {0};
+    for (uint32_t i = 1; i < length; ++i)
+    {
+        const uint32_t shift = kLetterBits * (length - 1 - i);
+        if ((diff >> shift) & 1)
+            counts[(answer >> shift) & 0x1F]++;
+    }
+
+    uint32_t pattern = 0;
+    for (uint32_t i = 1; i < length; ++i)
+    {
+        const uint32_t shift = kLetterBits * (length - 1 - i);
+        if ((diff >> shift) & 1)
+        {
+            uint8_t& c = counts[(guess >> shift) & 0x1F];
+            const uint32_t s = c > 0 ? (uint32_t)State::IN_WORD : (uint32_t)State::NOT_IN_WORD;
+            c -= (c > 0);
+            pattern += s * kPow3[i - 1];
+        }
+    }
+    return (Pattern)pattern;
+}
+
+// The block loops need 64 bits lanes compares to vectorise well: an AVX2
+// version is built too, picked when the program loads (gcc, clang on linux)
+#if defined(__x86_64__) && defined(__linux__) && defined(__GNUC__)
+#define FEEDBACK_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define FEEDBACK_CLONES
+#endif
+
+// Left to right as ComputeFeedback, but a mask of the answer positions
+// already used up replaces the letter counts: a guess letter that is not in
+// place takes the first unmatched, unused copy of it in the answer, if any.
+// Answers are scored in blocks kept in registers, with no table lookup nor
+// branch.
+FEEDBACK_CLONES
+void ComputeFeedbacks(uint64_t guess, const uint64_t* answers, std::size_t count, uint32_t length, Pattern* patterns)
+{
+    constexpr std::size_t kBlock = 16;
+
+    // Scored positions (all but the first), position i at bit 5 * (length - 1 - i)
+    const uint64_t scored = kLowBits & ((uint64_t(1) << (kLetterBits * (length - 1))) - 1);
+
+    for (std::size_t first = 0; first < count; first += kBlock)
+    {
+        const std::size_t n = std::min(kBlock, count - first);
+        const uint64_t* block = answers + first;
+        uint64_t diff[kBlock];
+        uint64_t used[kBlock];
+        uint32_t pattern[kBlock];
+        for (std::size_t b = 0; b < n; ++b)
+        {
+            diff[b] = NonZeroFields(guess ^ block[b]) & scored;
+            used[b] = 0;
+            pattern[b] = 0;
+        }
+
+        for (uint32_t i = 1; i < length; ++i)
+        {
+            const uint32_t shift = kLetterBits * (length - 1 - i);
+            const uint64_t spread = ((guess >> shift) & 0x1F) * kLowBits; // The letter in every field
+            const uint32_t weight = kPow3[i - 1];
+
+            for (std::size_t b = 0; b < n; ++b)
+            {
+                const uint64_t open = (diff[b] >> shift) & 1;
+                const uint64_t copies = ~NonZeroFields(block[b] ^ spread) & diff[b] & ~used[b];
+                used[b] |= copies & (0 - copies) & (0 - open);
+                pattern[b] += (uint32_t)open * (2 - (copies != 0)) * weight;
+            }
+        }
+
+        for (std::size_t b = 0; b < n; ++b)
+            patterns[first + b] = (Pattern)pattern[b];
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+#include "word.h"
+
+enum class State 
+{
+    GOOD_POSITION = 0,
+    IN_WORD = 1,
+    NOT_IN_WORD = 2,
+    UNKNOWN = 3
+};
+
+// Feedback of a guess against an answer of the same length. The first letter
+// is forced by the game and always GOOD_POSITION, the state of the others
+// (GOOD_POSITION, IN_WORD or NOT_IN_WORD) are the base 3 digits of the pattern,
+// position 1 being the least significant one. A solved word is pattern 0.
+using Pattern = uint16_t;
+
+constexpr uint32_t kMaxFeedbackLength = 10;
+constexpr Pattern  kWinPattern = 0;
+
+constexpr std::array<uint32_t, kMaxFeedbackLength + 1> kPow3 = {
+    1, 3, 9, 27, 81, 243, 729, 2187, 6561, 19683, 59049
+};
+
+// Number of distinct patterns for words of the given length
+inline uint32_t PatternCount(uint32_t length)
+{
+    return kPow3[length - 1];
+}
+
+inline State PatternState(Pattern p, uint32_t i)
+{
+    if (i == 0) return State::GOOD_POSITION;
+    return (State)((p / kPow3[i - 1]) % 3);
+}
+
+// Score a packed guess against a packed answer (see word.h), following the
+// game rules: exact letters first, then remaining letters left to right as
+// long as the answer still has unmatched copies of them. The first letter is
+// excluded from letter counts.
+Pattern ComputeFeedback(uint64_t guess, uint64_t answer, uint32_t length);
+
+// Same feedback against count answers at once: for each guess position the
+// answers are scored by a loop of branch free 64 bits operations, which the
+// compiler vectorises.
+void ComputeFeedbacks(uint64_t guess, const uint64_t* answers, std::size_t count, uint32_t length, Pattern* patterns);
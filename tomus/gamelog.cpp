@@ -0,0 +1,49 @@
+#include <cstring>
+
+#include "gamelog.h"
+
+bool GameLogWriter::Open(const std::string& path, GameLogHeader header)
+{
+    std::memcpy(header.magic, kGameLogMagic, sizeof(header.magic));
+    header.version = kGameLogVersion;
+    header.startTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    start = std::chrono::steady_clock::now();
+    return (bool)file;
+}
+
+void GameLogWriter::Write(GameEvent event)
+{
+    if (!file.is_open())
+        return;
+
+    event.time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    file.write(reinterpret_cast<const char*>(&event), sizeof(event));
+}
+
+void GameLogWriter::Flush()
+{
+    file.flush();
+}
+
+bool ReadGameLog(const std::string& path, GameLogHeader& header, std::vector<GameEvent>& events)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+    if (std::memcmp(header.magic, kGameLogMagic, sizeof(header.magic)) != 0 || header.version != kGameLogVersion)
+        return false;
+
+    // A truncated last event (crash while writing) is dropped
+    GameEvent event;
+    events.clear();
+    while (file.read(reinterpret_cast<char*>(&event), sizeof(event)))
+        events.push_back(event);
+    return true;
+}
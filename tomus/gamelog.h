@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Binary log of a game: a header followed by fixed size events, enough to
+// replay the game through the engine (see tomus_replay).
+constexpr char     kGameLogMagic[8] = {'T', 'O', 'M', 'U', 'S', 'L', 'O', 'G'};
+constexpr uint32_t kGameLogVersion  = 1;
+
+struct GameLogHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t wordCount;  // Size of Config::words, to detect other dictionaries
+    uint64_t seed;
+    uint64_t startTime;  // Unix time, in ms
+    uint32_t minLength;
+    uint32_t maxLength;
+    uint32_t maxTries;
+    uint32_t padding;
+};
+
+enum class GameEventType : uint8_t
+{
+    NEW_WORD = 0,   // value: word index, result: 1 if drawn at random
+    INPUT = 1,      // value: PackedWord bits of the input, result: InputResult
+    SWAP_WORD = 2   // value: word index (absurd mode)
+};
+
+struct GameEvent
+{
+    uint32_t time;  // ms since the start of the log
+    GameEventType type;
+    uint8_t result;
+    uint16_t pattern;
+    uint64_t value;
+};
+
+struct GameLogWriter
+{
+    bool Open(const std::string& path, GameLogHeader header);
+    void Write(GameEvent event);
+    void Flush();
+private:
+    std::ofstream file;
+    std::chrono::steady_clock::time_point start;
+};
+
+bool ReadGameLog(const std::string& path, GameLogHeader& header, std::vector<GameEvent>& events);
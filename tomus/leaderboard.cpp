@@ -0,0 +1,616 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include <nlohmann/json.hpp>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "leaderboard.h"
+#include "tomus.h"
+
+constexpr char     kLogMagic[8]   = {'T', 'O', 'M', 'U', 'S', 'L', 'B', 'D'};
+constexpr char     kIndexMagic[8] = {'T', 'O', 'M', 'U', 'S', 'L', 'B', 'I'};
+constexpr uint32_t kLeaderboardVersion = 1;
+
+struct LogHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t padding;
+};
+
+struct IndexHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t entries;
+    uint64_t logSize;   // The index is only valid for a log of this size
+    uint64_t count;     // Records in the log
+};
+
+// Record: RecordHeader, then a payload made of RecordFixed, the name, and
+// for each game its number of guesses and the guesses
+struct RecordHeader
+{
+    uint32_t size;
+    uint32_t checksum;
+};
+
+struct RecordFixed
+{
+    int32_t score;
+    int32_t wordCount;
+    int32_t time;
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint64_t seed;
+    uint16_t nameLength;
+    uint16_t gameCount;
+    uint32_t puzzle;
+};
+
+// FNV-1a, enough to tell a torn write from a record
+static uint32_t Checksum(const char* data, std::size_t size)
+{
+    uint32_t h = 0x811c9dc5u;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        h ^= (uint8_t)data[i];
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+static bool Sync(std::FILE* file)
+{
+    if (std::fflush(file) != 0)
+        return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+static void Encode(const LeaderboardEntry& e, bool withGuesses, std::vector<char>& out)
+{
+    RecordFixed fixed;
+    std::memset(&fixed, 0, sizeof(fixed));
+    fixed.score = e.score;
+    fixed.wordCount = e.wordCount;
+    fixed.time = e.time;
+    fixed.year = e.year;
+    fixed.month = e.month;
+    fixed.day = e.day;
+    fixed.seed = e.seed;
+    fixed.puzzle = e.puzzle;
+    fixed.nameLength = std::min<std::size_t>(e.name.size(), UINT16_MAX);
+    fixed.gameCount = withGuesses ? std::min<std::size_t>(e.guesses.size(), UINT16_MAX) : 0;
+
+    out.resize(sizeof(RecordHeader));
+    const auto put = [&](const void* data, std::size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    };
+    put(&fixed, sizeof(fixed));
+    put(e.name.data(), fixed.nameLength);
+    for (std::size_t g = 0; g < fixed.gameCount; ++g)
+    {
+        const uint8_t tries = std::min<std::size_t>(e.guesses[g].size(), UINT8_MAX);
+        put(&tries, 1);
+        put(e.guesses[g].data(), tries * sizeof(uint64_t));
+    }
+
+    RecordHeader header;
+    header.size = out.size() - sizeof(RecordHeader);
+    header.checksum = Checksum(out.data() + sizeof(RecordHeader), header.size);
+    std::memcpy(out.data(), &header, sizeof(header));
+}
+
+// Guesses are only decoded when entry is given
+static bool Decode(const char* data, std::size_t size, LeaderboardSummary& s, LeaderboardEntry* entry)
+{
+    RecordFixed fixed;
+    if (size < sizeof(fixed))
+        return false;
+    std::memcpy(&fixed, data, sizeof(fixed));
+    if (sizeof(fixed) + fixed.nameLength > size)
+        return false;
+
+    s.name.assign(data + sizeof(fixed), fixed.nameLength);
+    s.score = fixed.score;
+    s.wordCount = fixed.wordCount;
+    s.time = fixed.time;
+    s.year = fixed.year;
+    s.month = fixed.month;
+    s.day = fixed.day;
+    s.seed = fixed.seed;
+    s.puzzle = fixed.puzzle;
+    if (!entry)
+        return true;
+
+    entry->name = s.name;
+    entry->score = s.score;
+    entry->wordCount = s.wordCount;
+    entry->time = s.time;
+    entry->year = s.year;
+    entry->month = s.month;
+    entry->day = s.day;
+    entry->seed = s.seed;
+    entry->puzzle = s.puzzle;
+    entry->guesses.assign(fixed.gameCount, {});
+
+    std::size_t pos = sizeof(fixed) + fixed.nameLength;
+    for (auto& game : entry->guesses)
+    {
+        if (pos + 1 > size)
+            return false;
+        const uint8_t tries = (uint8_t)data[pos++];
+        if (pos + tries * sizeof(uint64_t) > size)
+            return false;
+        game.resize(tries);
+        std::memcpy(game.data(), data + pos, tries * sizeof(uint64_t));
+        pos += tries * sizeof(uint64_t);
+    }
+    return true;
+}
+
+// Largest payload Encode can write: the name, then per game its try count
+// and the tries
+constexpr uint64_t kMaxRecordSize = sizeof(RecordFixed) + UINT16_MAX + UINT16_MAX * (1 + UINT8_MAX * sizeof(uint64_t));
+
+enum class RecordRead
+{
+    OK,
+    END,        // End of the file, or a record running past it (a torn tail)
+    DAMAGED,    // Within the file but failing its checksum, payload has its size
+    INVALID     // Header size no record can have, what follows is unreadable
+};
+
+// Record at the current position. left is the bytes from the record to the
+// end of the file: a torn header must not allocate gigabytes before the
+// checksum can tell.
+static RecordRead ReadRecord(std::FILE* file, std::vector<char>& payload, uint64_t left = kMaxRecordSize)
+{
+    RecordHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1)
+        return RecordRead::END;
+    if (header.size > left - std::min<uint64_t>(left, sizeof(header)))
+        return RecordRead::END;
+    if (header.size > kMaxRecordSize)
+        return RecordRead::INVALID;
+    payload.resize(header.size);
+    if (header.size > 0 && std::fread(payload.data(), header.size, 1, file) != 1)
+        return RecordRead::END;
+    return Checksum(payload.data(), payload.size()) == header.checksum ? RecordRead::OK : RecordRead::DAMAGED;
+}
+
+static uint32_t PeriodKey(uint16_t year, uint8_t month, uint8_t day)
+{
+    return year * 10000u + month * 100u + day;
+}
+
+bool Leaderboard::Rank::operator()(const LeaderboardSummary* a, const LeaderboardSummary* b) const
+{
+    if (a->score != b->score)
+        return a->score > b->score;
+    if (a->time != b->time)
+        return a->time < b->time;
+    return a->offset < b->offset;
+}
+
+Leaderboard::~Leaderboard()
+{
+    Close();
+}
+
+bool Leaderboard::Open(const std::string& basePath)
+{
+    Close();
+    logPath = basePath + ".log";
+    indexPath = basePath + ".idx";
+
+    if (!std::filesystem::exists(logPath))
+    {
+        std::FILE* file = std::fopen(logPath.c_str(), "wb");
+        if (!file)
+            return false;
+
+        LogHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kLogMagic, sizeof(header.magic));
+        header.version = kLeaderboardVersion;
+        const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 && Sync(file);
+        std::fclose(file);
+        if (!written)
+            return false;
+    }
+
+    log = std::fopen(logPath.c_str(), "r+b");
+    if (!log)
+        return false;
+
+    LogHeader header;
+    if (std::fread(&header, sizeof(header), 1, log) != 1
+        || std::memcmp(header.magic, kLogMagic, sizeof(header.magic)) != 0
+        || header.version != kLeaderboardVersion)
+    {
+        Close();
+        return false;
+    }
+
+    std::fseek(log, 0, SEEK_END);
+    logSize = std::ftell(log);
+
+    // A stale index (crash between the log and the index writes) is rebuilt
+    if (LoadIndex())
+        return true;
+    if (Catalog())
+        return true;
+    Close();
+    return false;
+}
+
+void Leaderboard::Close()
+{
+    if (log)
+        std::fclose(log);
+    log = nullptr;
+    logSize = 0;
+    count = 0;
+    cataloged = false;
+    all.clear();
+    periods.clear();
+    puzzles.clear();
+    summaries.clear();
+}
+
+bool Leaderboard::Catalog()
+{
+    all.clear();
+    periods.clear();
+    puzzles.clear();
+    summaries.clear();
+    count = 0;
+    cataloged = true;
+
+    std::vector<char> payload;
+    uint64_t end = sizeof(LogHeader);
+    std::size_t damaged = 0;
+    std::fseek(log, end, SEEK_SET);
+    while (true)
+    {
+        const RecordRead r = ReadRecord(log, payload, logSize - std::min(logSize, end));
+        if (r == RecordRead::END)
+            break;
+        if (r == RecordRead::INVALID)
+        {
+            std::cerr << "Error, damaged leaderboard record header at " << end << ": " << logPath << std::endl;
+            return false;
+        }
+
+        // Damaged records are skipped by their size, Compact drops them
+        LeaderboardSummary s;
+        if (r == RecordRead::OK && Decode(payload.data(), payload.size(), s, nullptr))
+        {
+            s.offset = end;
+            Add(s);
+            count++;
+        }
+        else
+            damaged++;
+        end += sizeof(RecordHeader) + payload.size();
+    }
+    if (damaged > 0)
+        std::cerr << "Warning, " << damaged << " damaged leaderboard records skipped: " << logPath << std::endl;
+
+    // Drop the torn tail, so appends stay readable
+    if (end != logSize)
+    {
+        std::fclose(log);
+        std::error_code ec;
+        std::filesystem::resize_file(logPath, end, ec);
+        log = std::fopen(logPath.c_str(), "r+b");
+        if (ec || !log)
+            return false;
+        logSize = end;
+    }
+    return SaveIndex();
+}
+
+void Leaderboard::Add(const LeaderboardSummary& summary)
+{
+    if (!cataloged)
+    {
+        // Only the index entries are known, keep the best kIndexSize
+        if (all.size() >= kIndexSize && !Rank{}(&summary, *all.rbegin()))
+            return;
+        summaries.push_back(summary);
+        all.insert(&summaries.back());
+        if (all.size() > kIndexSize)
+            all.erase(std::prev(all.end()));
+
+        // Evicted summaries stay behind in the deque, drop them once they
+        // pile up so that long running stores do not grow
+        if (summaries.size() >= 2 * kIndexSize)
+        {
+            std::deque<LeaderboardSummary> kept;
+            for (const LeaderboardSummary* k : all)
+                kept.push_back(*k);
+            summaries.swap(kept);
+            all.clear();
+            for (const LeaderboardSummary& k : summaries)
+                all.insert(&k);
+        }
+        return;
+    }
+
+    summaries.push_back(summary);
+    const LeaderboardSummary* s = &summaries.back();
+    all.insert(s);
+    periods[PeriodKey(s->year, 0, 0)].insert(s);
+    periods[PeriodKey(s->year, s->month, 0)].insert(s);
+    periods[PeriodKey(s->year, s->month, s->day)].insert(s);
+    if (s->puzzle != 0)
+        puzzles[s->puzzle].insert(s);
+}
+
+bool Leaderboard::Append(const std::vector<LeaderboardEntry>& entries)
+{
+    if (!log)
+        return false;
+
+    std::fseek(log, logSize, SEEK_SET);
+    std::vector<char> record;
+    std::vector<LeaderboardSummary> added;
+    uint64_t end = logSize;
+    for (const LeaderboardEntry& e : entries)
+    {
+        Encode(e, true, record);
+        if (std::fwrite(record.data(), record.size(), 1, log) != 1)
+            return false;
+
+        LeaderboardSummary s;
+        Decode(record.data() + sizeof(RecordHeader), record.size() - sizeof(RecordHeader), s, nullptr);
+        s.offset = end;
+        added.push_back(s);
+        end += record.size();
+    }
+
+    // The entries exist once synced, the index only speeds up the next open
+    if (!Sync(log))
+        return false;
+    logSize = end;
+    for (const LeaderboardSummary& s : added)
+        Add(s);
+    count += added.size();
+    return SaveIndex();
+}
+
+bool Leaderboard::Insert(const LeaderboardEntry& entry)
+{
+    return Append({entry});
+}
+
+bool Leaderboard::Insert(const std::vector<LeaderboardEntry>& entries)
+{
+    return Append(entries);
+}
+
+std::vector<LeaderboardSummary> Leaderboard::Top(std::size_t k, LeaderboardPeriod period)
+{
+    const bool anyPeriod = period.year == 0 && period.puzzle == 0;
+    if (!cataloged && (!anyPeriod || (k > all.size() && count > all.size())))
+        Catalog();
+
+    const Ranking* ranking = &all;
+    if (period.puzzle != 0)
+    {
+        const auto it = puzzles.find(period.puzzle);
+        if (it == puzzles.end())
+            return {};
+        ranking = &it->second;
+    }
+    else if (!anyPeriod)
+    {
+        const auto it = periods.find(PeriodKey(period.year, period.month, period.month ? period.day : 0));
+        if (it == periods.end())
+            return {};
+        ranking = &it->second;
+    }
+
+    std::vector<LeaderboardSummary> top;
+    for (auto it = ranking->begin(); it != ranking->end() && top.size() < k; ++it)
+        top.push_back(**it);
+    return top;
+}
+
+bool Leaderboard::Read(const LeaderboardSummary& summary, LeaderboardEntry& entry)
+{
+    if (!log || std::fseek(log, summary.offset, SEEK_SET) != 0)
+        return false;
+
+    std::vector<char> payload;
+    LeaderboardSummary s;
+    return ReadRecord(log, payload, logSize - std::min(logSize, summary.offset)) == RecordRead::OK && Decode(payload.data(), payload.size(), s, &entry);
+}
+
+std::size_t Leaderboard::Size() const
+{
+    return count;
+}
+
+bool Leaderboard::SaveIndex()
+{
+    const std::string tmpPath = indexPath + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file)
+        return false;
+
+    IndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kIndexMagic, sizeof(header.magic));
+    header.version = kLeaderboardVersion;
+    header.entries = std::min(all.size(), kIndexSize);
+    header.logSize = logSize;
+    header.count = count;
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    std::vector<char> record;
+    auto it = all.begin();
+    for (uint32_t i = 0; i < header.entries && written; ++i, ++it)
+    {
+        const LeaderboardSummary& s = **it;
+        LeaderboardEntry e;
+        e.name = s.name;
+        e.score = s.score;
+        e.wordCount = s.wordCount;
+        e.time = s.time;
+        e.year = s.year;
+        e.month = s.month;
+        e.day = s.day;
+        e.seed = s.seed;
+        e.puzzle = s.puzzle;
+        Encode(e, false, record);
+        written = std::fwrite(&s.offset, sizeof(s.offset), 1, file) == 1
+               && std::fwrite(record.data(), record.size(), 1, file) == 1;
+    }
+    written = written && Sync(file);
+    std::fclose(file);
+
+    std::error_code ec;
+    if (written)
+        std::filesystem::rename(tmpPath, indexPath, ec);
+    return written && !ec;
+}
+
+bool Leaderboard::LoadIndex()
+{
+    std::FILE* file = std::fopen(indexPath.c_str(), "rb");
+    if (!file)
+        return false;
+
+    IndexHeader header;
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1
+              && std::memcmp(header.magic, kIndexMagic, sizeof(header.magic)) == 0
+              && header.version == kLeaderboardVersion
+              && header.logSize == logSize;
+
+    std::vector<LeaderboardSummary> entries;
+    std::vector<char> payload;
+    for (uint32_t i = 0; i < header.entries && valid; ++i)
+    {
+        LeaderboardSummary s;
+        valid = std::fread(&s.offset, sizeof(s.offset), 1, file) == 1
+             && ReadRecord(file, payload) == RecordRead::OK
+             && Decode(payload.data(), payload.size(), s, nullptr);
+        entries.push_back(s);
+    }
+    std::fclose(file);
+    if (!valid)
+        return false;
+
+    cataloged = false;
+    for (const LeaderboardSummary& s : entries)
+        Add(s);
+    count = header.count;
+    return true;
+}
+
+bool Leaderboard::Compact(bool keepGuesses)
+{
+    if (!log || (!cataloged && !Catalog()))
+        return false;
+
+    std::set<uint64_t> indexed;
+    for (auto it = all.begin(); it != all.end() && indexed.size() < kIndexSize; ++it)
+        indexed.insert((*it)->offset);
+
+    const std::string tmpPath = logPath + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file)
+        return false;
+
+    LogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kLogMagic, sizeof(header.magic));
+    header.version = kLeaderboardVersion;
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // Summaries are in log order
+    std::vector<char> record;
+    LeaderboardEntry entry;
+    for (std::size_t i = 0; i < summaries.size() && written; ++i)
+    {
+        written = Read(summaries[i], entry);
+        Encode(entry, keepGuesses || indexed.count(summaries[i].offset), record);
+        written = written && std::fwrite(record.data(), record.size(), 1, file) == 1;
+    }
+    written = written && Sync(file);
+    std::fclose(file);
+    if (!written)
+        return false;
+
+    // Offsets change: the index goes first, a crash before the rename then
+    // leaves the old log to catalog
+    const std::string base = logPath.substr(0, logPath.size() - 4);
+    Close();
+    std::error_code ec;
+    std::filesystem::remove(indexPath, ec);
+    std::filesystem::rename(tmpPath, logPath, ec);
+    return Open(base) && !ec;
+}
+
+bool Leaderboard::ImportJson(const std::string& path)
+{
+    using json = nlohmann::json;
+
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::vector<LeaderboardEntry> entries;
+    try
+    {
+        const json data = json::parse(file);
+        for (const auto& item : data)
+        {
+            LeaderboardEntry e;
+            e.name = item["name"].get<std::string>();
+            e.score = item["score"].get<int>();
+            e.wordCount = item["wordCount"].get<int>();
+            e.time = item["time"].get<int>();
+            e.day = item["day"].get<int>();
+            e.month = item["month"].get<int>();
+            e.year = item["year"].get<int>();
+            e.seed = item.value("seed", uint64_t(0));
+
+            // Initial tries ("m......") are not guesses and do not pack
+            for (const auto& game : item.value("guesses", json::array()))
+            {
+                e.guesses.push_back({});
+                for (const auto& guess : game)
+                {
+                    const std::string word = guess.get<std::string>();
+                    uint64_t code;
+                    if (word.size() < kMaxPackedLength && PackWord(word, code))
+                        e.guesses.back().push_back(PackedWord(code, word.size()).bits);
+                }
+            }
+            entries.push_back(std::move(e));
+        }
+    }
+    catch (std::exception&)
+    {
+        return false;
+    }
+    return Append(entries);
+}
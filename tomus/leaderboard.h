@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// One finished run, guesses being the inputs of each game as PackedWord bits
+struct LeaderboardEntry
+{
+    std::string name;
+    int32_t score = 0;
+    int32_t wordCount = 0;
+    int32_t time = 0;
+    uint16_t year = 0;
+    uint8_t month = 0;
+    uint8_t day = 0;
+    uint64_t seed = 0;
+    uint32_t puzzle = 0;    // Daily puzzle id (DailyPuzzleId), 0 for free games
+    std::vector<std::vector<uint64_t>> guesses;
+};
+
+// An entry without its guesses, as ranked by the leaderboard. offset locates
+// the full entry in the log.
+struct LeaderboardSummary
+{
+    std::string name;
+    int32_t score = 0;
+    int32_t wordCount = 0;
+    int32_t time = 0;
+    uint16_t year = 0;
+    uint8_t month = 0;
+    uint8_t day = 0;
+    uint64_t seed = 0;
+    uint32_t puzzle = 0;
+    uint64_t offset = 0;
+};
+
+// Zero fields match anything, month needs a year and day a month. A puzzle
+// only ranks the entries of that daily puzzle, the date is then ignored.
+struct LeaderboardPeriod
+{
+    uint16_t year = 0;
+    uint8_t month = 0;
+    uint8_t day = 0;
+    uint32_t puzzle = 0;
+};
+
+// Leaderboard stored as two files:
+//
+//   <base>.log  append-only records (size, checksum, entry), each insert
+//               is appended and synced, records are never rewritten
+//   <base>.idx  the kIndexSize best summaries and the log size they cover,
+//               replaced atomically (write, sync, rename) after each insert
+//
+// Opening only reads the index when it covers the whole log, so the all time
+// top is available without reading the log. The log is scanned ("cataloged")
+// when the index is stale, after a crash, or when a query needs more than the
+// index holds; a torn tail is then cut off, damaged records within the log
+// are skipped (and dropped by Compact).
+//
+// Ranking: best score first, then shortest time, then oldest. Insertion is
+// O(log n), top-k O(k) from the start of an ordered set, per period and per
+// daily puzzle too.
+struct Leaderboard
+{
+    static constexpr std::size_t kIndexSize = 64;
+
+    Leaderboard()
+    {}
+    ~Leaderboard();
+
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+
+    bool Open(const std::string& basePath);
+    void Close();
+
+    bool Insert(const LeaderboardEntry& entry);
+
+    // All of them with a single sync
+    bool Insert(const std::vector<LeaderboardEntry>& entries);
+
+    // Best k entries of the period, best first
+    std::vector<LeaderboardSummary> Top(std::size_t k, LeaderboardPeriod period = {});
+
+    // Full entry, guesses included
+    bool Read(const LeaderboardSummary& summary, LeaderboardEntry& entry);
+
+    // Rewrite the log without its unreadable records, and without the
+    // guesses of the entries outside the index unless keepGuesses. The old
+    // log is replaced atomically.
+    bool Compact(bool keepGuesses = true);
+
+    // Append the entries of the former leaderboard.json
+    bool ImportJson(const std::string& path);
+
+    std::size_t Size() const;
+private:
+    struct Rank
+    {
+        bool operator()(const LeaderboardSummary* a, const LeaderboardSummary* b) const;
+    };
+    using Ranking = std::set<const LeaderboardSummary*, Rank>;
+
+    bool Catalog();
+    bool Append(const std::vector<LeaderboardEntry>& entries);
+    void Add(const LeaderboardSummary& summary);
+    bool SaveIndex();
+    bool LoadIndex();
+
+    std::string logPath;
+    std::string indexPath;
+    std::FILE* log = nullptr;
+    uint64_t logSize = 0;
+    std::size_t count = 0;
+
+    // All summaries once cataloged, otherwise the index ones only
+    bool cataloged = false;
+    std::deque<LeaderboardSummary> summaries;
+    Ranking all;
+    std::map<uint32_t, Ranking> periods; // By yyyymmdd, 0 for any month or day
+    std::map<uint32_t, Ranking> puzzles;
+};
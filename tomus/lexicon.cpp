@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include "lexicon.h"
+
+void Lexicon::Insert(const std::vector<std::string>& words)
+{
+    std::array<std::vector<uint64_t>, kMaxPackedLength + 1> perLength;
+    for (uint32_t l = 0; l <= kMaxPackedLength; ++l)
+        perLength[l].assign(buckets[l].begin(), buckets[l].end());
+
+    for (const auto& w : words)
+    {
+        uint64_t code;
+        if (PackWord(w, code))
+            perLength[w.size()].push_back(code);
+    }
+
+    std::size_t total = 0;
+    Counts counts;
+    for (uint32_t l = 0; l <= kMaxPackedLength; ++l)
+    {
+        auto& b = perLength[l];
+        std::sort(b.begin(), b.end());
+        b.erase(std::unique(b.begin(), b.end()), b.end());
+
+        counts[l] = b.size();
+        total += b.size();
+    }
+
+    std::vector<uint64_t> codes;
+    codes.reserve(total);
+    for (const auto& b : perLength)
+        codes.insert(codes.end(), b.begin(), b.end());
+
+    auto owned = std::make_shared<const std::vector<uint64_t>>(std::move(codes));
+    Build(owned, owned->data(), counts);
+}
+
+Lexicon::Lexicon(std::shared_ptr<const void> owner, const uint64_t* codes, const Counts& counts)
+{
+    Build(std::move(owner), codes, counts);
+}
+
+void Lexicon::Build(std::shared_ptr<const void> owner, const uint64_t* codes, const Counts& counts)
+{
+    std::size_t offset = 0;
+    for (uint32_t l = 0; l <= kMaxPackedLength; ++l)
+    {
+        buckets[l] = std::span<const uint64_t>(codes + offset, counts[l]);
+        offset += counts[l];
+    }
+    storage = std::move(owner);
+}
+
+bool Lexicon::Contains(std::string_view word) const
+{
+    uint64_t code;
+    if (!PackWord(word, code))
+        return false;
+
+    // Branchless lower bound: the loop only depends on the bucket size
+    const auto bucket = buckets[word.size()];
+    if (bucket.size() == 0)
+        return false;
+
+    const uint64_t* base = bucket.data();
+    std::size_t n = bucket.size();
+    while (n > 1)
+    {
+        const std::size_t half = n / 2;
+        base = (base[half - 1] < code) ? base + half : base;
+        n -= half;
+    }
+    return *base == code;
+}
+
+std::span<const uint64_t> Lexicon::Bucket(uint32_t length) const
+{
+    if (length > kMaxPackedLength)
+        return {};
+    return buckets[length];
+}
+
+std::size_t Lexicon::Size() const
+{
+    std::size_t total = 0;
+    for (const auto& b : buckets)
+        total += b.size();
+    return total;
+}
+
+std::size_t Lexicon::MemoryUsage() const
+{
+    return sizeof(Lexicon) + Size() * sizeof(uint64_t);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <string>
+#include <array>
+#include <span>
+
+#include "word.h"
+
+// Immutable set of words, bucketed by length. Each bucket is a sorted array of
+// packed words (see word.h), so a lookup is a binary search over 8 bytes keys
+// and never allocates. Copies share the same underlying storage.
+struct Lexicon
+{
+    using Counts = std::array<std::size_t, kMaxPackedLength + 1>;
+
+    Lexicon()
+    {}
+
+    // View over codes owned by someone else (eg. a mapped dictionary image)
+    Lexicon(std::shared_ptr<const void> owner, const uint64_t* codes, const Counts& counts);
+
+    // Merge words into the lexicon. Words that can not be packed (letters
+    // outside of a-z or too long) are ignored as they can not be typed anyway.
+    void Insert(const std::vector<std::string>& words);
+    bool Contains(std::string_view word) const;
+
+    std::span<const uint64_t> Bucket(uint32_t length) const;
+    std::size_t Size() const;
+    std::size_t MemoryUsage() const;
+private:
+    void Build(std::shared_ptr<const void> owner, const uint64_t* codes, const Counts& counts);
+
+    std::shared_ptr<const void> storage;
+    std::array<std::span<const uint64_t>, kMaxPackedLength + 1> buckets;
+};
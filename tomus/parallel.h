@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+inline unsigned int WorkerCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Run f(i, worker) for every i in [0, n) over all cores. Indices are handed out
+// in small blocks so uneven work balances itself; worker is in
+// [0, WorkerCount()) and lets callers keep per thread scratch data.
+template<typename F>
+void ParallelFor(std::size_t n, F&& f, std::size_t block = 16)
+{
+    const unsigned int workers = std::min<std::size_t>(WorkerCount(), (n + block - 1) / block);
+    if (workers <= 1)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            f(i, 0u);
+        return;
+    }
+
+    std::atomic<std::size_t> next = 0;
+    const auto run = [&](unsigned int worker) {
+        while (true)
+        {
+            const std::size_t start = next.fetch_add(block);
+            if (start >= n) break;
+
+            const std::size_t end = std::min(n, start + block);
+            for (std::size_t i = start; i < end; ++i)
+                f(i, worker);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int w = 1; w < workers; ++w)
+        threads.emplace_back(run, w);
+    run(0);
+
+    for (auto& t : threads)
+        t.join();
+}
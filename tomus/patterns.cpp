@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cstring>
+
+#include "dictionary.h"
+#include "parallel.h"
+#include "patterns.h"
+
+constexpr char     kPatternsMagic[8] = {'T', 'O', 'M', 'U', 'S', 'P', 'A', 'T'};
+constexpr uint32_t kPatternsVersion  = 1;
+
+struct PatternsHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t length;
+    uint32_t guessCount;
+    uint32_t answerCount;
+    uint64_t guessHash;
+    PatternMatrix::Block blocks[26];
+
+    uint64_t answersOffset;
+    uint64_t dataOffset;
+    uint64_t fileSize;
+};
+
+struct OwnedPatterns
+{
+    std::vector<uint64_t> answers;
+    std::vector<Pattern> data;
+};
+
+uint64_t HashCodes(std::span<const uint64_t> codes)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (const uint64_t c : codes)
+    {
+        h ^= c;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+std::vector<uint64_t> PackedSolutions(const Config& conf, uint32_t length)
+{
+    std::vector<uint64_t> codes;
+    for (std::size_t i = 0; i < conf.words.size(); ++i)
+    {
+        uint64_t code;
+        if (conf.words[i].size() == length && PackWord(conf.words[i], code))
+            codes.push_back(code);
+    }
+    std::sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+    return codes;
+}
+
+void PatternMatrix::Index(const Config& conf, uint32_t l)
+{
+    length = l;
+    guesses = conf.admissibleWords.Bucket(l);
+
+    const uint32_t shift = kLetterBits * (l - 1);
+    uint64_t offset = 0;
+    for (uint32_t c = 0; c < 26; ++c)
+    {
+        const uint64_t first = uint64_t(c) << shift;
+        const uint64_t last  = uint64_t(c + 1) << shift;
+
+        const auto g0 = std::lower_bound(guesses.begin(), guesses.end(), first);
+        const auto g1 = std::lower_bound(guesses.begin(), guesses.end(), last);
+        const auto a0 = std::lower_bound(answers.begin(), answers.end(), first);
+        const auto a1 = std::lower_bound(answers.begin(), answers.end(), last);
+
+        Block& b = blocks[c];
+        b.guessBegin  = g0 - guesses.begin();
+        b.guessCount  = g1 - g0;
+        b.answerBegin = a0 - answers.begin();
+        b.answerCount = a1 - a0;
+        b.dataOffset  = offset;
+        offset += uint64_t(b.guessCount) * b.answerCount;
+    }
+}
+
+PatternMatrix PatternMatrix::Build(const Config& conf, uint32_t length)
+{
+    auto owned = std::make_shared<OwnedPatterns>();
+    owned->answers = PackedSolutions(conf, length);
+
+    PatternMatrix m;
+    m.answers = owned->answers;
+    m.Index(conf, length);
+
+    const Block& lastBlock = m.blocks[25];
+    owned->data.resize(lastBlock.dataOffset + uint64_t(lastBlock.guessCount) * lastBlock.answerCount);
+    m.data = owned->data.data();
+    m.storage = owned;
+
+    ParallelFor(m.guesses.size(), [&](std::size_t g, unsigned int) {
+        const Block& b = m.blocks[m.guesses[g] >> (kLetterBits * (length - 1))];
+        Pattern* row = owned->data.data() + b.dataOffset + std::size_t(g - b.guessBegin) * b.answerCount;
+        for (uint32_t a = 0; a < b.answerCount; ++a)
+            row[a] = ComputeFeedback(m.guesses[g], m.answers[b.answerBegin + a], length);
+    }, 64);
+    return m;
+}
+
+PatternMatrix PatternMatrix::LoadOrBuild(const std::string& path, const Config& conf, uint32_t length)
+{
+    PatternMatrix m;
+    if (m.Load(path, conf, length))
+        return m;
+
+    m = Build(conf, length);
+    if (!m.Save(path))
+        std::cerr << "Warning, can not save patterns to: " << path << std::endl;
+    return m;
+}
+
+bool PatternMatrix::Save(const std::string& path) const
+{
+    PatternsHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kPatternsMagic, sizeof(header.magic));
+    header.version     = kPatternsVersion;
+    header.length      = length;
+    header.guessCount  = guesses.size();
+    header.answerCount = answers.size();
+    header.guessHash   = HashCodes(guesses);
+    std::copy(blocks.begin(), blocks.end(), header.blocks);
+
+    const std::size_t count = blocks[25].dataOffset + uint64_t(blocks[25].guessCount) * blocks[25].answerCount;
+    header.answersOffset = sizeof(PatternsHeader);
+    header.dataOffset    = header.answersOffset + answers.size_bytes();
+    header.fileSize      = header.dataOffset + count * sizeof(Pattern);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(answers.data()), answers.size_bytes());
+    file.write(reinterpret_cast<const char*>(data), count * sizeof(Pattern));
+    return (bool)file;
+}
+
+bool PatternMatrix::Load(const std::string& path, const Config& conf, uint32_t l)
+{
+    auto file = MappedFile::Open(path);
+    if (!file || file->size < sizeof(PatternsHeader))
+        return false;
+
+    PatternsHeader header;
+    std::memcpy(&header, file->data, sizeof(header));
+    if (std::memcmp(header.magic, kPatternsMagic, sizeof(header.magic)) != 0)
+        return false;
+    if (header.version != kPatternsVersion || header.length != l || header.fileSize != file->size)
+        return false;
+
+    // Only reuse a matrix built from the very same lists
+    const auto bucket = conf.admissibleWords.Bucket(l);
+    if (header.guessCount != bucket.size() || header.guessHash != HashCodes(bucket))
+        return false;
+
+    // Sections within the file, sizes checked without overflowing
+    if (header.answersOffset % 8 != 0 || header.answersOffset > file->size
+        || header.answerCount > (file->size - header.answersOffset) / sizeof(uint64_t))
+        return false;
+    if (header.dataOffset % sizeof(Pattern) != 0 || header.dataOffset > file->size)
+        return false;
+    const uint64_t patternCount = (file->size - header.dataOffset) / sizeof(Pattern);
+    for (const Block& b : header.blocks)
+        if (b.dataOffset > patternCount || uint64_t(b.guessCount) * b.answerCount > patternCount - b.dataOffset)
+            return false;
+
+    const auto expected = PackedSolutions(conf, l);
+    const auto* stored = reinterpret_cast<const uint64_t*>(file->data + header.answersOffset);
+    if (header.answerCount != expected.size() || !std::equal(expected.begin(), expected.end(), stored))
+        return false;
+
+    PatternMatrix m;
+    m.answers = std::span<const uint64_t>(stored, header.answerCount);
+    m.Index(conf, l);
+    if (!std::equal(m.blocks.begin(), m.blocks.end(), header.blocks, [](const Block& a, const Block& b) {
+        return a.dataOffset == b.dataOffset && a.guessCount == b.guessCount && a.answerCount == b.answerCount;
+    }))
+        return false;
+
+    m.data = reinterpret_cast<const Pattern*>(file->data + header.dataOffset);
+    m.storage = file;
+    *this = m;
+    return true;
+}
+
+std::size_t PatternMatrix::MemoryUsage() const
+{
+    const std::size_t count = blocks[25].dataOffset + uint64_t(blocks[25].guessCount) * blocks[25].answerCount;
+    return sizeof(PatternMatrix) + answers.size_bytes() + count * sizeof(Pattern);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <array>
+#include <span>
+
+#include "config.h"
+#include "feedback.h"
+
+// Feedback of every admissible guess against every solution of one word
+// length. The game forces the first letter, so only pairs sharing it are
+// stored: one dense block per first letter, a row per guess and a column per
+// answer.
+//
+// Guesses are the admissible lexicon bucket of that length (indices are
+// bucket indices), answers the sorted packed solutions of that length.
+struct PatternMatrix
+{
+    struct Block
+    {
+        uint32_t guessBegin;
+        uint32_t guessCount;
+        uint32_t answerBegin;
+        uint32_t answerCount;
+        uint64_t dataOffset;
+    };
+
+    PatternMatrix()
+    {}
+
+    // Compute the matrix over all cores
+    static PatternMatrix Build(const Config& conf, uint32_t length);
+
+    // Load path when it holds the matrix of the current lists, otherwise
+    // build it and save it to path for the next run
+    static PatternMatrix LoadOrBuild(const std::string& path, const Config& conf, uint32_t length);
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path, const Config& conf, uint32_t length);
+
+    uint32_t Length() const
+    {
+        return length;
+    }
+
+    std::span<const uint64_t> Guesses() const
+    {
+        return guesses;
+    }
+
+    std::span<const uint64_t> Answers() const
+    {
+        return answers;
+    }
+
+    const Block& LetterBlock(uint32_t letter) const
+    {
+        return blocks[letter];
+    }
+
+    // Patterns of guess against the answers of its block
+    const Pattern* Row(uint32_t guess) const
+    {
+        const Block& b = blocks[guesses[guess] >> (kLetterBits * (length - 1))];
+        return data + b.dataOffset + std::size_t(guess - b.guessBegin) * b.answerCount;
+    }
+
+    Pattern At(uint32_t guess, uint32_t answer) const
+    {
+        const Block& b = blocks[guesses[guess] >> (kLetterBits * (length - 1))];
+        return Row(guess)[answer - b.answerBegin];
+    }
+
+    std::size_t MemoryUsage() const;
+private:
+    void Index(const Config& conf, uint32_t length);
+
+    uint32_t length = 0;
+    std::span<const uint64_t> guesses;
+    std::span<const uint64_t> answers;
+    std::array<Block, 26> blocks{};
+
+    std::shared_ptr<const void> storage;
+    const Pattern* data = nullptr;
+};
+
+// FNV-1a over packed words, to detect sidecar files built for other lists
+uint64_t HashCodes(std::span<const uint64_t> codes);
+
+// Sorted, unique packed solutions of the given length
+std::vector<uint64_t> PackedSolutions(const Config& conf, uint32_t length);
@@ -0,0 +1,188 @@
+#include "profile.h"
+
+#ifdef TOMUS_PROFILE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+// One writer (its thread), any number of readers
+struct ProfileRing
+{
+    static constexpr std::size_t kCapacity = 1 << 14;
+
+    // seq is 2 * index + 1 while the slot is written, 2 * index + 2 once done
+    struct Slot
+    {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> value{0};
+        std::atomic<bool> counter{false};
+    };
+
+    void Push(const char* name, uint64_t start, uint64_t value, bool counter)
+    {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        Slot& s = slots[h & (kCapacity - 1)];
+        s.seq.store(2 * h + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.name.store(name, std::memory_order_relaxed);
+        s.start.store(start, std::memory_order_relaxed);
+        s.value.store(value, std::memory_order_relaxed);
+        s.counter.store(counter, std::memory_order_relaxed);
+        s.seq.store(2 * h + 2, std::memory_order_release);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    void Copy(std::vector<ProfileEvent>& out) const
+    {
+        const uint64_t h = head.load(std::memory_order_acquire);
+        for (uint64_t i = h > kCapacity ? h - kCapacity : 0; i < h; ++i)
+        {
+            const Slot& s = slots[i & (kCapacity - 1)];
+            const uint64_t before = s.seq.load(std::memory_order_acquire);
+            ProfileEvent e;
+            e.name = s.name.load(std::memory_order_relaxed);
+            e.start = s.start.load(std::memory_order_relaxed);
+            e.value = s.value.load(std::memory_order_relaxed);
+            e.counter = s.counter.load(std::memory_order_relaxed);
+            e.thread = thread;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (before == 2 * i + 2 && s.seq.load(std::memory_order_relaxed) == before)
+                out.push_back(e);
+        }
+    }
+
+    uint32_t thread = 0;
+    bool inUse = false; // Guarded by ringsMutex
+    std::atomic<uint64_t> head{0};
+    Slot slots[kCapacity];
+};
+
+// Rings outlive their threads, so a trace keeps the events of finished jobs.
+// The ring of a finished thread goes to the next new thread (ParallelFor
+// starts new ones on each call), events are then appended after its own.
+static std::mutex ringsMutex;
+static std::vector<std::unique_ptr<ProfileRing>> rings;
+
+struct RingOwner
+{
+    RingOwner()
+    {
+        std::lock_guard lock(ringsMutex);
+        for (const auto& r : rings)
+            if (!r->inUse)
+                ring = r.get();
+        if (!ring)
+        {
+            rings.push_back(std::make_unique<ProfileRing>());
+            ring = rings.back().get();
+            ring->thread = rings.size() - 1;
+        }
+        ring->inUse = true;
+    }
+
+    ~RingOwner()
+    {
+        std::lock_guard lock(ringsMutex);
+        ring->inUse = false;
+    }
+
+    ProfileRing* ring = nullptr;
+};
+
+static ProfileRing& ThreadRing()
+{
+    thread_local RingOwner owner;
+    return *owner.ring;
+}
+
+uint64_t ProfileNow()
+{
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void ProfileRecord(const char* name, uint64_t start, uint64_t duration)
+{
+    ThreadRing().Push(name, start, duration, false);
+}
+
+void ProfileCount(const char* name, uint64_t value)
+{
+    ThreadRing().Push(name, ProfileNow(), value, true);
+}
+
+std::vector<ProfileEvent> ProfileSnapshot()
+{
+    std::vector<const ProfileRing*> current;
+    {
+        std::lock_guard lock(ringsMutex);
+        for (const auto& r : rings)
+            current.push_back(r.get());
+    }
+
+    std::vector<ProfileEvent> events;
+    for (const ProfileRing* r : current)
+        r->Copy(events);
+    return events;
+}
+
+std::vector<ProfileStat> ProfileStats(uint64_t window)
+{
+    const uint64_t now = ProfileNow();
+    const uint64_t since = now > window ? now - window : 0;
+
+    std::map<std::string_view, ProfileStat> byName;
+    for (const ProfileEvent& e : ProfileSnapshot())
+    {
+        if (e.counter || e.start + e.value < since)
+            continue;
+        ProfileStat& s = byName.try_emplace(e.name, ProfileStat{e.name, 0, 0., 0.}).first->second;
+        const double ms = e.value / 1e6;
+        s.calls++;
+        s.totalMs += ms;
+        s.maxMs = std::max(s.maxMs, ms);
+    }
+
+    std::vector<ProfileStat> stats;
+    for (const auto& [name, s] : byName)
+        stats.push_back(s);
+    std::sort(stats.begin(), stats.end(), [](const ProfileStat& a, const ProfileStat& b) { return a.totalMs > b.totalMs; });
+    return stats;
+}
+
+bool ExportChromeTrace(const std::string& path)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    // Names are string literals of the instrumented code, nothing to escape.
+    // Times are in us, with ns digits.
+    file << std::fixed;
+    file.precision(3);
+    file << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (const ProfileEvent& e : ProfileSnapshot())
+    {
+        file << (first ? "" : ",\n");
+        first = false;
+        if (e.counter)
+            file << "{\"name\":\"" << e.name << "\",\"ph\":\"C\",\"ts\":" << e.start / 1e3
+                 << ",\"pid\":1,\"tid\":" << e.thread << ",\"args\":{\"value\":" << e.value << "}}";
+        else
+            file << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"ts\":" << e.start / 1e3
+                 << ",\"dur\":" << e.value / 1e3 << ",\"pid\":1,\"tid\":" << e.thread << "}";
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return (bool)file;
+}
+
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+
+// Hot path instrumentation, only built with TOMUS_PROFILE defined (cmake
+// -DTOMUS_PROFILE=ON):
+//
+//   TOMUS_PROFILE_SCOPE("Tomus::Input");    times the enclosing scope
+//   TOMUS_PROFILE_COUNT("tries", n);        records a counter value
+//
+// Each thread appends its events to its own fixed size ring, with plain
+// stores only: no lock and no read-modify-write on the hot path. Readers (the
+// in-game overlay, the Chrome trace export) copy the rings at any time, each
+// slot is guarded by a sequence number so events overwritten during the copy
+// are dropped. Without TOMUS_PROFILE the macros expand to nothing (counter
+// values are not even evaluated) and no profiler code is compiled.
+
+#ifdef TOMUS_PROFILE
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ProfileEvent
+{
+    const char* name;
+    uint64_t start;     // ns since the first event of the process
+    uint64_t value;     // Duration in ns, or the counter value
+    uint32_t thread;    // In registration order, from 0
+    bool counter;
+};
+
+struct ProfileStat
+{
+    const char* name;
+    uint64_t calls;
+    double totalMs;
+    double maxMs;
+};
+
+uint64_t ProfileNow();
+void ProfileRecord(const char* name, uint64_t start, uint64_t duration);
+void ProfileCount(const char* name, uint64_t value);
+
+// Events still held by the rings, by thread then in order
+std::vector<ProfileEvent> ProfileSnapshot();
+
+// Scopes ended within the last window ns, by name, largest total first
+std::vector<ProfileStat> ProfileStats(uint64_t window);
+
+// Chrome trace event format, for chrome://tracing or ui.perfetto.dev
+bool ExportChromeTrace(const std::string& path);
+
+struct ProfileScope
+{
+    ProfileScope(const char* n) : name(n), start(ProfileNow())
+    {}
+    ~ProfileScope()
+    {
+        ProfileRecord(name, start, ProfileNow() - start);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define TOMUS_PROFILE_JOIN2(a, b) a##b
+#define TOMUS_PROFILE_JOIN(a, b) TOMUS_PROFILE_JOIN2(a, b)
+#define TOMUS_PROFILE_SCOPE(name) ProfileScope TOMUS_PROFILE_JOIN(profileScope, __LINE__)(name)
+#define TOMUS_PROFILE_COUNT(name, value) ProfileCount(name, value)
+
+#else
+
+#define TOMUS_PROFILE_SCOPE(name) ((void)0)
+#define TOMUS_PROFILE_COUNT(name, value) ((void)0)
+
+#endif
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+// xoshiro256** generator, seeded through splitmix64. Much smaller and faster
+// than std::mt19937 and fully determined by a 64 bits seed, so games can be
+// replayed. Satisfies UniformRandomBitGenerator.
+struct Rng
+{
+    using result_type = uint64_t;
+
+    Rng(uint64_t seed = 0)
+    {
+        Seed(seed);
+    }
+
+    void Seed(uint64_t seed)
+    {
+        for (auto& s : state)
+        {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            s = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t operator()()
+    {
+        const uint64_t result = Rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = Rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, n), n > 0 (Lemire's nearly divisionless method)
+    uint32_t Below(uint32_t n)
+    {
+        uint64_t m = (uint64_t)Next32() * n;
+        uint32_t low = (uint32_t)m;
+        if (low < n)
+        {
+            const uint32_t threshold = (0u - n) % n;
+            while (low < threshold)
+            {
+                m = (uint64_t)Next32() * n;
+                low = (uint32_t)m;
+            }
+        }
+        return (uint32_t)(m >> 32);
+    }
+
+    uint32_t Next32()
+    {
+        return (uint32_t)((*this)() >> 32);
+    }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+private:
+    static uint64_t Rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t state[4];
+};
+
+// Discrete distribution over [0, n) from non negative weights (Vose's alias
+// method): O(n) to build, then O(1) per draw whatever the weights, a bounded
+// draw and a 32 bits coin. Integer draws, so a seed gives the same sequence
+// on every platform.
+struct AliasTable
+{
+    AliasTable()
+    {}
+
+    explicit AliasTable(std::span<const double> weights) :
+        threshold(weights.size(), 0), alias(weights.size(), 0)
+    {
+        const std::size_t n = weights.size();
+        double total = 0.;
+        for (const double w : weights)
+            total += w;
+
+        // Probabilities scaled to the average bucket, split in small and large
+        std::vector<double> scaled(n);
+        std::vector<uint32_t> small, large;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            scaled[i] = total > 0. ? weights[i] * n / total : 1.;
+            (scaled[i] < 1. ? small : large).push_back(i);
+        }
+
+        // Each small bucket is topped up by a large one
+        while (!small.empty() && !large.empty())
+        {
+            const uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+            threshold[s] = (uint64_t)(scaled[s] * 4294967296.);
+            alias[s] = l;
+            scaled[l] -= 1. - scaled[s];
+            if (scaled[l] < 1.)
+            {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+
+        // Left overs are full buckets, up to rounding
+        for (const uint32_t i : large)
+            threshold[i] = uint64_t(1) << 32;
+        for (const uint32_t i : small)
+            threshold[i] = uint64_t(1) << 32;
+    }
+
+    uint32_t operator()(Rng& gen) const
+    {
+        const uint32_t i = gen.Below(threshold.size());
+        return gen.Next32() < threshold[i] ? i : alias[i];
+    }
+
+    std::size_t size() const
+    {
+        return threshold.size();
+    }
+private:
+    std::vector<uint64_t> threshold; // Chance to keep the bucket, over 2^32
+    std::vector<uint32_t> alias;
+};
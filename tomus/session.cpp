@@ -0,0 +1,94 @@
+#include "session.h"
+
+SessionPool::SessionPool(const Config& c, uint64_t seed) : config(c), gen(seed)
+{ }
+
+SessionId SessionPool::Open()
+{
+    uint32_t slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        if (slots % kPageSize == 0)
+            pages.push_back(std::make_unique<Session[]>(kPageSize));
+        slot = slots++;
+    }
+
+    Session& s = pages[slot / kPageSize][slot % kPageSize];
+    const uint32_t generation = s.generation + 1;
+    s = Session{};
+    s.generation = generation;
+    s.live = true;
+    live++;
+
+    NewWord(s);
+    return (SessionId(generation) << 32) | slot;
+}
+
+void SessionPool::Close(SessionId id)
+{
+    Session* s = Get(id);
+    if (!s)
+        return;
+
+    s->live = false;
+    freeSlots.push_back((uint32_t)id);
+    live--;
+}
+
+Session* SessionPool::Get(SessionId id)
+{
+    const uint32_t slot = (uint32_t)id;
+    if (slot >= slots)
+        return nullptr;
+
+    Session& s = pages[slot / kPageSize][slot % kPageSize];
+    if (!s.live || s.generation != (uint32_t)(id >> 32))
+        return nullptr;
+    return &s;
+}
+
+void SessionPool::NewWord(Session& s)
+{
+    const std::string_view word = config.words[gen.Below(config.words.size())];
+
+    PackWord(word, s.answer);
+    s.length = word.size();
+    s.tries = 0;
+}
+
+InputResult SessionPool::Input(Session& s, std::string_view input)
+{
+    uint64_t guess;
+    Pattern pattern;
+    const InputResult r = ScoreInput(config, s.answer, s.length, input, guess, pattern);
+    if (r != InputResult::VALID && r != InputResult::WIN)
+        return r;
+
+    s.guesses[s.tries] = guess;
+    s.patterns[s.tries] = pattern;
+    s.tries++;
+
+    if (r == InputResult::WIN)
+    {
+        s.score += computeScore(s.tries);
+        s.words++;
+        return InputResult::WIN;
+    }
+
+    if (s.tries >= std::min(config.maxTries, kMaxSessionTries))
+    {
+        s.over = true;
+        return InputResult::LOSE;
+    }
+    return InputResult::VALID;
+}
+
+std::size_t SessionPool::Size() const
+{
+    return live;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tomus.h"
+
+constexpr uint32_t kMaxSessionTries = 16;
+
+// Compact state of one game, for hosting many of them (see tomus_server).
+// Same rules as Tomus, but tries are packed guesses and their feedback
+// instead of Try records, so a session never allocates.
+struct Session
+{
+    uint64_t answer = 0;
+    uint64_t guesses[kMaxSessionTries];
+    Pattern patterns[kMaxSessionTries];
+
+    uint32_t generation = 0;
+    uint32_t score = 0;
+    uint32_t words = 0;
+    uint8_t length = 0;
+    uint8_t tries = 0;
+    bool live = false;
+    bool over = false;
+};
+
+// Session id: generation in the high bits, slot in the low ones, so that ids
+// of closed sessions are never mistaken for the session reusing their slot
+using SessionId = uint64_t;
+
+// Sessions are allocated by pages of fixed size records and recycled through
+// a free list: opening and closing sessions does not allocate once the pool
+// reached its peak size, and records never move.
+struct SessionPool
+{
+    SessionPool(const Config& c, uint64_t seed);
+
+    SessionId Open();
+    void Close(SessionId id);
+
+    // nullptr for unknown or closed ids
+    Session* Get(SessionId id);
+
+    void NewWord(Session& s);
+    InputResult Input(Session& s, std::string_view input);
+
+    std::size_t Size() const;
+    const Config& config;
+private:
+    static constexpr uint32_t kPageSize = 4096;
+
+    std::vector<std::unique_ptr<Session[]>> pages;
+    std::vector<uint32_t> freeSlots;
+    uint32_t slots = 0;
+    std::size_t live = 0;
+
+    Rng gen;
+};
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+
+#include "sharedboard.h"
+
+struct SharedLeaderboard::ThreadState
+{
+    struct Chunk
+    {
+        LeaderboardEntry entries[kChunkSize];
+        std::atomic<std::size_t> written{0};
+        std::atomic<Chunk*> next{nullptr};
+    };
+
+    ThreadState() : head(new Chunk), tail(head)
+    {}
+
+    ~ThreadState()
+    {
+        while (head)
+            delete std::exchange(head, head->next.load());
+    }
+
+    // Owning thread only
+    void Push(LeaderboardEntry&& entry)
+    {
+        std::size_t w = tail->written.load(std::memory_order_relaxed);
+        if (w == kChunkSize)
+        {
+            Chunk* c = new Chunk;
+            tail->next.store(c, std::memory_order_release);
+            tail = c;
+            w = 0;
+        }
+        tail->entries[w] = std::move(entry);
+        tail->written.store(w + 1, std::memory_order_release);
+    }
+
+    // Merge thread only. A chunk is freed once the next one exists, the
+    // producer never goes back to it.
+    void Drain(std::vector<LeaderboardEntry>& out)
+    {
+        while (true)
+        {
+            const std::size_t w = head->written.load(std::memory_order_acquire);
+            for (; read < w; ++read)
+                out.push_back(std::move(head->entries[read]));
+            if (read < kChunkSize)
+                return;
+
+            Chunk* next = head->next.load(std::memory_order_acquire);
+            if (!next)
+                return;
+            delete std::exchange(head, next);
+            read = 0;
+        }
+    }
+
+    // Consumer and producer ends on their own cache lines
+    Chunk* head;
+    std::size_t read = 0;
+    alignas(64) Chunk* tail;
+
+    // Epoch of the read in progress, 0 outside reads
+    alignas(64) std::atomic<uint64_t> epoch{0};
+    uint32_t depth = 0; // Owning thread only
+};
+
+static uint64_t NextBoardId()
+{
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1);
+}
+
+static bool Better(const LeaderboardSummary& a, const LeaderboardSummary& b)
+{
+    if (a.score != b.score)
+        return a.score > b.score;
+    return a.time < b.time;
+}
+
+SharedLeaderboard::SharedLeaderboard(std::size_t c, Leaderboard* s, std::chrono::milliseconds i) :
+    capacity(c), store(s), interval(i), id(NextBoardId())
+{
+    auto* first = new Snapshot;
+    if (store)
+    {
+        first->top = store->Top(capacity);
+        first->entries = store->Size();
+    }
+    current.store(first);
+    thread = std::thread(&SharedLeaderboard::Run, this);
+}
+
+SharedLeaderboard::~SharedLeaderboard()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+
+    // No reader can be left once the board goes
+    for (const auto& [e, snapshot] : retired)
+        delete snapshot;
+    delete current.load();
+}
+
+SharedLeaderboard::ThreadState& SharedLeaderboard::Local() const
+{
+    // The last board used by the thread first, most threads only use one
+    thread_local std::pair<uint64_t, ThreadState*> last{0, nullptr};
+    thread_local std::unordered_map<uint64_t, ThreadState*> registry;
+    if (last.first == id)
+        return *last.second;
+
+    ThreadState*& state = registry[id];
+    if (!state)
+    {
+        std::lock_guard lock(statesMutex);
+        states.push_back(std::make_unique<ThreadState>());
+        state = states.back().get();
+    }
+    last = {id, state};
+    return *state;
+}
+
+void SharedLeaderboard::Insert(LeaderboardEntry entry)
+{
+    Local().Push(std::move(entry));
+}
+
+// The epoch is announced before the snapshot is loaded (both sequentially
+// consistent): a snapshot retired at epoch E is only reachable from reads
+// announced at E or before.
+SharedLeaderboard::ReadGuard::ReadGuard(const SharedLeaderboard& board) : state(board.Local())
+{
+    if (state.depth++ == 0)
+        state.epoch.store(board.epoch.load());
+    snapshot = board.current.load();
+}
+
+SharedLeaderboard::ReadGuard::~ReadGuard()
+{
+    if (--state.depth == 0)
+        state.epoch.store(0, std::memory_order_release);
+}
+
+SharedLeaderboard::ReadGuard SharedLeaderboard::Read() const
+{
+    return ReadGuard(*this);
+}
+
+std::vector<LeaderboardSummary> SharedLeaderboard::Top(std::size_t k) const
+{
+    const ReadGuard snapshot = Read();
+    const auto& top = snapshot->top;
+    return std::vector<LeaderboardSummary>(top.begin(), top.begin() + std::min(k, top.size()));
+}
+
+void SharedLeaderboard::Sync()
+{
+    std::unique_lock lock(mutex);
+    const uint64_t ticket = ++requested;
+    wake.notify_all();
+    merged.wait(lock, [&]() { return served >= ticket; });
+}
+
+void SharedLeaderboard::Run()
+{
+    std::unique_lock lock(mutex);
+    while (true)
+    {
+        wake.wait_for(lock, interval, [&]() { return stopping || requested > served; });
+        const bool last = stopping;
+        const uint64_t serving = requested;
+        lock.unlock();
+
+        Merge();
+
+        lock.lock();
+        served = serving;
+        merged.notify_all();
+        if (last)
+            break;
+    }
+}
+
+void SharedLeaderboard::Merge()
+{
+    std::vector<ThreadState*> buffers;
+    {
+        std::lock_guard lock(statesMutex);
+        for (const auto& s : states)
+            buffers.push_back(s.get());
+    }
+
+    std::vector<LeaderboardEntry> batch;
+    for (ThreadState* s : buffers)
+        s->Drain(batch);
+
+    if (!batch.empty())
+    {
+        std::vector<LeaderboardSummary> fresh;
+        for (const LeaderboardEntry& e : batch)
+            fresh.push_back({e.name, e.score, e.wordCount, e.time, e.year, e.month, e.day, e.seed, e.puzzle, 0});
+        std::stable_sort(fresh.begin(), fresh.end(), Better);
+
+        const Snapshot* old = current.load(std::memory_order_acquire);
+        auto* next = new Snapshot;
+        std::merge(old->top.begin(), old->top.end(), fresh.begin(), fresh.end(), std::back_inserter(next->top), Better);
+        if (next->top.size() > capacity)
+            next->top.resize(capacity);
+        next->entries = old->entries + batch.size();
+        next->merges = old->merges + 1;
+
+        current.store(next);
+        retired.push_back({epoch.fetch_add(1), old});
+
+        // Readers already see the entries, the disk can take its time
+        if (store && !store->Insert(batch))
+            std::cerr << "Warning, can not save " << batch.size() << " leaderboard entries" << std::endl;
+    }
+    Reclaim();
+}
+
+void SharedLeaderboard::Reclaim()
+{
+    if (retired.empty())
+        return;
+
+    uint64_t oldest = ~uint64_t(0);
+    {
+        std::lock_guard lock(statesMutex);
+        for (const auto& s : states)
+            if (const uint64_t e = s->epoch.load())
+                oldest = std::min(oldest, e);
+    }
+
+    std::erase_if(retired, [&](const std::pair<uint64_t, const Snapshot*>& r) {
+        if (r.first >= oldest)
+            return false;
+        delete r.second;
+        return true;
+    });
+}
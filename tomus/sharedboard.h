@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "leaderboard.h"
+
+// Top of the leaderboard shared by many threads (see tomus_server): any
+// thread inserts finished runs and reads the current top, the ranking work
+// and the disk writes happen on a background merge thread.
+//
+//   Insert  moves the entry into a buffer owned by the calling thread, a
+//           list of fixed size chunks with a single producer (that thread)
+//           and a single consumer (the merge thread): O(1), no lock, no
+//           read-modify-write, a chunk allocation every kChunkSize entries.
+//   merge   every interval, drains the buffers, merges the new entries into
+//           a copy of the top and publishes it with an atomic pointer swap,
+//           then appends the entries to the Leaderboard store if any.
+//   Read    pins the current snapshot without locking: the thread announces
+//           the epoch it reads in, loads the snapshot pointer, and clears
+//           its epoch when done. Replaced snapshots are freed by the merge
+//           thread once no reader is left in an epoch that could see them
+//           (epoch based reclamation, a form of RCU).
+//
+// Readers see a consistent top, at most one interval late. The first call of
+// a thread registers its buffer, under a lock, once; buffers outlive their
+// threads until the board is destroyed. Ranking is the Leaderboard one (best
+// score, then shortest time), equal entries keep their merge order.
+struct SharedLeaderboard
+{
+    static constexpr std::size_t kChunkSize = 256;
+
+    struct ThreadState; // Insert buffer and reader epoch of one thread
+
+    struct Snapshot
+    {
+        std::vector<LeaderboardSummary> top; // Best first, at most capacity
+        uint64_t entries = 0;                // Ever merged, store included
+        uint64_t merges = 0;
+    };
+
+    // Keeps the top capacity entries. The store, when given, seeds the top
+    // and receives every entry; it then belongs to the merge thread.
+    SharedLeaderboard(std::size_t capacity = Leaderboard::kIndexSize, Leaderboard* store = nullptr,
+                      std::chrono::milliseconds interval = std::chrono::milliseconds(20));
+
+    // Merges the entries still buffered, then stops the merge thread
+    ~SharedLeaderboard();
+
+    SharedLeaderboard(const SharedLeaderboard&) = delete;
+    SharedLeaderboard& operator=(const SharedLeaderboard&) = delete;
+
+    void Insert(LeaderboardEntry entry);
+
+    // The snapshot stays valid while the guard lives, guards may nest
+    struct ReadGuard
+    {
+        ~ReadGuard();
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const Snapshot& operator*() const { return *snapshot; }
+        const Snapshot* operator->() const { return snapshot; }
+    private:
+        friend struct SharedLeaderboard;
+        ReadGuard(const SharedLeaderboard& board);
+
+        ThreadState& state;
+        const Snapshot* snapshot;
+    };
+
+    ReadGuard Read() const;
+
+    // Best k entries of the current snapshot
+    std::vector<LeaderboardSummary> Top(std::size_t k) const;
+
+    // Wait for a merge started after the call, so that the entries inserted
+    // before by this thread are visible
+    void Sync();
+private:
+    ThreadState& Local() const;
+    void Run();
+    void Merge();
+    void Reclaim();
+
+    const std::size_t capacity;
+    Leaderboard* store;
+    const std::chrono::milliseconds interval;
+    const uint64_t id; // Tells the boards apart in the thread local registry
+
+    // Readers and the publication
+    std::atomic<const Snapshot*> current;
+    std::atomic<uint64_t> epoch{1};
+    std::vector<std::pair<uint64_t, const Snapshot*>> retired; // Merge thread only
+
+    // Per thread buffers and reader epochs, the list only grows
+    mutable std::mutex statesMutex;
+    mutable std::vector<std::unique_ptr<ThreadState>> states;
+
+    // Merge thread pacing, Sync and shutdown
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable merged;
+    uint64_t requested = 0;
+    uint64_t served = 0;
+    bool stopping = false;
+    std::thread thread;
+};
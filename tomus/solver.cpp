@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cmath>
+
+#include "parallel.h"
+#include "solver.h"
+
+Solver::Solver(const Config& c, bool p) : config(c), parallel(p)
+{
+    for (uint32_t l = 1; l <= kMaxFeedbackLength; ++l)
+        solutions[l] = PackedSolutions(config, l);
+
+    counts.resize(parallel ? WorkerCount() : 1);
+}
+
+void Solver::UseMatrix(const PatternMatrix& m)
+{
+    // Rows are addressed by lexicon bucket index
+    const uint32_t l = m.Length();
+    if (l <= kMaxFeedbackLength && m.Guesses().data() == config.admissibleWords.Bucket(l).data()
+        && m.Answers().size() == solutions[l].size())
+        matrices[l] = &m;
+}
+
+void Solver::Reset(PackedWord w)
+{
+    const uint32_t l = w.size();
+    const uint32_t c = w[0] - 'a';
+
+    word    = w;
+    length  = l;
+    letter  = c;
+    applied = 1; // tries[0] only holds the forced first letter
+
+    const uint32_t shift = kLetterBits * (l - 1);
+    const uint64_t first = uint64_t(c) << shift;
+    const uint64_t last  = uint64_t(c + 1) << shift;
+
+    const auto bucket = config.admissibleWords.Bucket(l);
+    const auto g0 = std::lower_bound(bucket.begin(), bucket.end(), first);
+    const auto g1 = std::lower_bound(bucket.begin(), bucket.end(), last);
+    guesses = std::span<const uint64_t>(g0, g1);
+
+    const auto& sols = solutions[l];
+    const auto a0 = std::lower_bound(sols.begin(), sols.end(), first);
+    const auto a1 = std::lower_bound(sols.begin(), sols.end(), last);
+    candidates.resize(a1 - a0);
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+        candidates[i] = (a0 - sols.begin()) + i;
+
+    for (auto& h : counts)
+        h.assign(PatternCount(l), 0);
+}
+
+bool Solver::Update(const std::vector<Try>& tries)
+{
+    const PackedWord w = tries[0].word;
+    if (w.size() < 2 || w.size() > kMaxFeedbackLength)
+        return false;
+
+    // The word is only used to notice that a new game started
+    const bool sameGame = (w.bits == word.bits) && tries.size() >= applied && 
+        (applied <= 1 || tries[applied - 1].input.bits == lastInput.bits);
+    if (!sameGame)
+        Reset(w);
+
+    // Incremental pruning: only the tries made since the last call
+    const auto& sols = solutions[length];
+    for (; applied < tries.size(); ++applied)
+    {
+        const uint64_t guess = tries[applied].input.Code();
+        const Pattern p = tries[applied].Feedback();
+        std::erase_if(candidates, [&](uint32_t a) {
+            return ComputeFeedback(guess, sols[a], length) != p;
+        });
+        lastInput = tries[applied].input;
+    }
+    return true;
+}
+
+std::string Solver::Hint(const std::vector<Try>& tries)
+{
+    if (!Update(tries) || candidates.empty())
+        return "";
+
+    const auto& sols = solutions[length];
+
+    uint64_t best;
+    const uint32_t remaining = config.maxTries + 1 - std::min<std::size_t>(tries.size(), config.maxTries + 1);
+    if (candidates.size() <= 2 || remaining <= 1)
+    {
+        // No room (or no need) to explore: play the most informative candidate
+        best = sols[candidates[Best(true)]];
+    }
+    else if (tries.size() == 1)
+    {
+        // Openings only depend on the first letter
+        auto& opening = openings[length][letter];
+        if (opening.empty())
+            opening = UnpackWord(guesses[Best(false)], length);
+        return opening;
+    }
+    else
+    {
+        best = guesses[Best(false)];
+    }
+
+    return UnpackWord(best, length);
+}
+
+uint32_t Solver::Best(bool candidatesOnly)
+{
+    const auto& sols = solutions[length];
+    const std::size_t n = candidates.size();
+    const PatternMatrix* matrix = matrices[length];
+
+    cLogC.resize(n + 1);
+    for (std::size_t i = 0; i < cLogC.size(); ++i)
+        cLogC[i] = i > 0 ? i * std::log2((double)i) : 0.0;
+
+    candidateCodes.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+        candidateCodes[i] = sols[candidates[i]];
+
+    const std::size_t pool = candidatesOnly ? n : guesses.size();
+    const auto code = [&](std::size_t g) {
+        return candidatesOnly ? sols[candidates[g]] : guesses[g];
+    };
+
+    // Entropy is log2(n) - sum(c log2 c) / n over the pattern classes: only
+    // the sum is compared, candidates win ties as they may end the game
+    struct Choice
+    {
+        double score = 1e300;
+        std::size_t index = 0;
+    };
+    std::vector<Choice> bests(counts.size());
+
+    const auto evaluate = [&](std::size_t g, unsigned int worker) {
+        auto& h = counts[worker];
+        const uint64_t guess = code(g);
+
+        const Pattern* row = nullptr;
+        uint32_t rowBegin = 0;
+        if (matrix && !candidatesOnly)
+        {
+            const auto bucketIndex = (guesses.data() - matrix->Guesses().data()) + g;
+            row = matrix->Row(bucketIndex);
+            rowBegin = matrix->LetterBlock(letter).answerBegin;
+        }
+
+        for (const uint32_t a : candidates)
+        {
+            const Pattern p = row ? row[a - rowBegin] : ComputeFeedback(guess, sols[a], length);
+            h[p]++;
+        }
+
+        double sum = 0.0;
+        for (const uint32_t a : candidates)
+        {
+            const Pattern p = row ? row[a - rowBegin] : ComputeFeedback(guess, sols[a], length);
+            sum += cLogC[h[p]];
+            h[p] = 0;
+        }
+
+        const bool isCandidate = candidatesOnly || std::binary_search(candidateCodes.begin(), candidateCodes.end(), guess);
+        const double score = sum - (isCandidate ? 1.0 : 0.0);
+
+        Choice& b = bests[worker];
+        if (score < b.score || (score == b.score && g < b.index))
+            b = Choice{score, g};
+    };
+
+    if (parallel)
+        ParallelFor(pool, evaluate, 64);
+    else
+        for (std::size_t g = 0; g < pool; ++g)
+            evaluate(g, 0);
+
+    Choice best;
+    for (const Choice& b : bests)
+    {
+        if (b.score < best.score || (b.score == best.score && b.index < best.index))
+            best = b;
+    }
+    return best.index;
+}
+
+std::size_t Solver::Candidates() const
+{
+    return candidates.size();
+}
+
+uint64_t Solver::Candidate(std::size_t i) const
+{
+    return solutions[length][candidates[i]];
+}
+
+std::span<const uint64_t> Solver::Guesses() const
+{
+    return guesses;
+}
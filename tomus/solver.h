@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+
+#include "patterns.h"
+#include "tomus.h"
+
+// Suggests the guess maximising the expected information (entropy of the
+// feedback over the remaining candidates) for a game in progress.
+//
+// The solver follows a single game at a time: each call only prunes the
+// candidate set with the tries it has not seen yet, and starts over when the
+// tries belong to another word. Guesses are evaluated over all cores unless
+// parallel is false (eg. when games are themselves spread over threads).
+struct Solver
+{
+    Solver(const Config& c, bool parallel = true);
+
+    // Use precomputed feedback for words of this length; m must outlive the solver
+    void UseMatrix(const PatternMatrix& m);
+
+    // Best next guess given the tries of the current word (Tomus::Tries()),
+    // empty if no solution word is consistent with them
+    std::string Hint(const std::vector<Try>& tries);
+
+    // Only prune the candidates with the tries, false if the word can not
+    // be solved (length out of bounds)
+    bool Update(const std::vector<Try>& tries);
+
+    // Solution words still consistent with the tries seen so far, packed
+    std::size_t Candidates() const;
+    uint64_t Candidate(std::size_t i) const;
+
+    // Admissible guesses for the current word, packed
+    std::span<const uint64_t> Guesses() const;
+
+    const Config& config;
+private:
+    void Reset(PackedWord word);
+    uint32_t Best(bool candidatesOnly);
+
+    bool parallel;
+    std::array<const PatternMatrix*, kMaxFeedbackLength + 1> matrices{};
+    std::array<std::vector<uint64_t>, kMaxFeedbackLength + 1> solutions;
+    std::array<std::array<std::string, 26>, kMaxFeedbackLength + 1> openings;
+
+    // Current game
+    PackedWord word;
+    PackedWord lastInput;
+    uint32_t length = 0;
+    uint32_t letter = 0;
+    std::size_t applied = 0;
+    std::span<const uint64_t> guesses;  // admissible words with the right first letter
+    std::vector<uint32_t> candidates;   // indices in solutions[length]
+    std::vector<uint64_t> candidateCodes;
+
+    std::vector<std::vector<uint32_t>> counts; // per worker pattern histograms
+    std::vector<double> cLogC;
+};
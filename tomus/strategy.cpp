@@ -0,0 +1,70 @@
+#include "strategy.h"
+
+struct RandomStrategy : public Strategy
+{
+    RandomStrategy(const Config& conf) : solver(conf, false)
+    { }
+
+    void Seed(uint64_t seed) override
+    {
+        gen.Seed(seed);
+    }
+
+    std::string Guess(const std::vector<Try>& tries) override
+    {
+        if (!solver.Update(tries) || solver.Guesses().empty())
+            return "";
+
+        const auto guesses = solver.Guesses();
+        return UnpackWord(guesses[gen.Below(guesses.size())], tries[0].word.size());
+    }
+
+    Solver solver;
+    Rng gen;
+};
+
+struct GreedyStrategy : public Strategy
+{
+    GreedyStrategy(const Config& conf) : solver(conf, false)
+    { }
+
+    void Seed(uint64_t seed) override
+    {
+        gen.Seed(seed);
+    }
+
+    std::string Guess(const std::vector<Try>& tries) override
+    {
+        if (!solver.Update(tries) || solver.Candidates() == 0)
+            return "";
+
+        return UnpackWord(solver.Candidate(gen.Below(solver.Candidates())), tries[0].word.size());
+    }
+
+    Solver solver;
+    Rng gen;
+};
+
+struct EntropyStrategy : public Strategy
+{
+    EntropyStrategy(const Config& conf, bool parallel) : solver(conf, parallel)
+    { }
+
+    void Seed(uint64_t) override
+    { }
+
+    std::string Guess(const std::vector<Try>& tries) override
+    {
+        return solver.Hint(tries);
+    }
+
+    Solver solver;
+};
+
+std::unique_ptr<Strategy> MakeStrategy(const std::string& name, const Config& conf, bool parallel)
+{
+    if (name == "random")  return std::make_unique<RandomStrategy>(conf);
+    if (name == "greedy")  return std::make_unique<GreedyStrategy>(conf);
+    if (name == "entropy") return std::make_unique<EntropyStrategy>(conf, parallel);
+    return nullptr;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "solver.h"
+
+// A way of playing a Tomus game automatically, see tomus_sim. Strategies keep
+// per game state and are not meant to be shared between threads.
+struct Strategy
+{
+    virtual ~Strategy() 
+    {}
+
+    // Called before each game, so that results do not depend on which thread
+    // played which word
+    virtual void Seed(uint64_t seed) = 0;
+
+    // Next guess for the tries of the current word, empty to give up
+    virtual std::string Guess(const std::vector<Try>& tries) = 0;
+};
+
+// "random" (any admissible word), "greedy" (any word consistent with the
+// feedback so far) or "entropy" (Solver hints). Returns nullptr for unknown names.
+std::unique_ptr<Strategy> MakeStrategy(const std::string& name, const Config& conf, bool parallel = false);
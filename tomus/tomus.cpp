@@ -1,4 +1,6 @@
 #include "tomus.h"
+#include "difficulty.h"
+#include "profile.h"
 
 uint32_t computeScore(uint32_t guess)
 {
@@ -14,115 +16,183 @@ uint32_t computeScore(uint32_t guess)
     }
 }
 
-Try::Try(std::string_view w) : 
-    word(w), input(w.size(), '.'),
-    states(w.size(), State::UNKNOWN),
-    bestStates(w.size(), State::UNKNOWN)
+Try::Try(std::string_view w, uint32_t index) : wordIndex(index)
 {
-    std::fill(letters.begin(), letters.end(), State::UNKNOWN);
+    uint64_t code = 0;
+    PackWord(w, code);
+    word  = PackedWord(code, w.size());
+    input = PackedWord(code, w.size(), true);
 
-    input[0] = w[0];
-    states[0] = State::GOOD_POSITION;
-    bestStates[0] = State::GOOD_POSITION;
+    states.Set(0, State::GOOD_POSITION);
+    bestStates.Set(0, State::GOOD_POSITION);
+}
+
+void Try::Apply(uint64_t in, Pattern pattern)
+{
+    const uint32_t length = word.size();
+    input = PackedWord(in, length);
+
+    // Letters scored somewhere in this input are in the word
+    uint32_t found = 0;
+    for (unsigned int i = 1; i < length; ++i)
+    {
+        const State s = PatternState(pattern, i);
+        const int idx = input[i] - 'a';
+
+        states.Set(i, State::UNKNOWN);
+        if (s == State::GOOD_POSITION)
+        {
+            states.Set(i, State::GOOD_POSITION);
+            letters.Set(idx, State::GOOD_POSITION);
+            bestStates.Set(i, State::GOOD_POSITION);
+        }
+        else if (s == State::IN_WORD)
+        {
+            states.Set(i, State::IN_WORD);
+
+            if (letters[idx] == State::UNKNOWN)
+                letters.Set(idx, State::IN_WORD);
+
+            if (bestStates[i] == State::UNKNOWN)
+                bestStates.Set(i, State::IN_WORD);
+        }
+
+        if (s != State::NOT_IN_WORD)
+            found |= 1u << idx;
+    }
+
+    // A letter only ever scored NOT_IN_WORD has no copy in the word
+    for (unsigned int i = 1; i < length; ++i)
+    {
+        const int idx = input[i] - 'a';
+        if (!((found >> idx) & 1))
+            letters.Set(idx, State::NOT_IN_WORD);
+    }
+}
+
+Pattern Try::Feedback() const
+{
+    uint32_t pattern = 0;
+    for (unsigned int i = 1; i < word.size(); ++i)
+    {
+        const State s = (states[i] == State::UNKNOWN) ? State::NOT_IN_WORD : states[i];
+        pattern += (uint32_t)s * kPow3[i - 1];
+    }
+    return (Pattern)pattern;
+}
+
+void Tomus::SetLog(GameLogWriter* l)
+{
+    log = l;
+}
+
+void Tomus::SetSampler(const WordSampler* s)
+{
+    sampler = s;
+}
+
+uint64_t Tomus::Seed() const
+{
+    return seed;
 }
 
 void Tomus::NewWord()
 {
-    std::uniform_int_distribution<std::size_t> dist(0, config.words.size() - 1);
-    
-    unsigned int idx = dist(gen);
+    TOMUS_PROFILE_SCOPE("Tomus::NewWord");
+    const std::size_t idx = sampler ? sampler->Draw(gen, history.size()) : gen.Below(config.words.size());
+    if (log)
+        log->Write({0, GameEventType::NEW_WORD, 1, 0, idx});
+    Start(idx);
+}
+
+void Tomus::NewWord(std::size_t idx)
+{
+    TOMUS_PROFILE_SCOPE("Tomus::NewWord");
+    if (log)
+        log->Write({0, GameEventType::NEW_WORD, 0, 0, idx});
+    Start(idx);
+}
+
+void Tomus::SwapWord(std::size_t idx)
+{
+    if (log)
+        log->Write({0, GameEventType::SWAP_WORD, 0, 0, idx});
+
+    // The initial try also holds the word as its input, first letter shown
+    const Try initial(config.words[idx], idx);
+    for (Try& t : currentTries)
+    {
+        t.word = initial.word;
+        t.wordIndex = idx;
+    }
+    currentTries[0].input = initial.input;
+}
+
+void Tomus::Start(std::size_t idx)
+{
     if (currentTries.size() > 0)
     {
-        history.push_back(currentTries);
+        history.Append(currentTries);
         score += computeScore(currentTries.size() - 1);
 
         currentTries.clear();
     }
-    currentTries.emplace_back(config.words[idx]);
+    currentTries.emplace_back(config.words[idx], idx);
 }
 
-InputResult Tomus::Input(const std::string& input)
+InputResult ScoreInput(const Config& config, uint64_t answer, uint32_t length, std::string_view input, uint64_t& guess, Pattern& pattern)
 {
-    const auto& lastTry = currentTries.back();
-
-    if (input.size() != lastTry.word.size())
+    if (input.size() != length)
         return InputResult::WRONG_LENGTH;
-    if (input[0] != lastTry.word[0])
+    if (input[0] != UnpackLetter(answer, length, 0))
         return InputResult::WRONG_LETTER;
     
     if (!config.IsWordAdmissible(input)) 
         return InputResult::UNKNOWN_WORD;
     
-    Try t = lastTry;
+    PackWord(input, guess); // Admissible words are always packable
+    pattern = ComputeFeedback(guess, answer, length);
 
-    // Copy input and reset letter states
-    t.input = std::string{input};
-    std::fill(t.states.begin() + 1, t.states.end(), State::UNKNOWN);
+    if (pattern == kWinPattern)
+        return InputResult::WIN;
+    return InputResult::VALID;
+}
 
-    for (unsigned int i = 1; i < t.word.size(); ++i)
-    {
-        const char current = input[i];
-        const int idx = current - 'a';
-        if (current == t.word[i])
-        {
-            t.states[i] = State::GOOD_POSITION;
-            t.letters[idx] = State::GOOD_POSITION;
-            t.bestStates[i] = State::GOOD_POSITION;
-        }
-    }
-    // Update configuration now
-    for (unsigned int i = 1; i < t.word.size(); ++i)
-    {
-        const char current = input[i];
-        const int idx = current - 'a';
-        if (current != t.word[i])
-        {
-            if (t.letters[idx] == State::NOT_IN_WORD)
-                continue;
-
-            int32_t countInWord  = 0;
-            int32_t countGoodPos = 0;
-            int32_t countLetter = 0;
-            
-            for (unsigned int j = 1; j < t.word.size(); ++j)
-            {
-                if (t.word[j] == current) countLetter++;
-
-                if (input[j] == current)
-                {
-                    if (t.states[j] == State::GOOD_POSITION)
-                        countGoodPos++;
-                    if (t.states[j] == State::IN_WORD)
-                        countInWord++;
-                }
-            }
-
-            if (countLetter == 0)
-            {
-                t.letters[idx] = State::NOT_IN_WORD;
-            }
-            else if (countLetter - countInWord - countGoodPos > 0)
-            {
-                t.states[i] = State::IN_WORD;
-
-                if (t.letters[idx] == State::UNKNOWN)
-                    t.letters[idx] = State::IN_WORD;
-
-                if (t.bestStates[i] == State::UNKNOWN)
-                    t.bestStates[i] = State::IN_WORD;
-            }
-        }
-    }
-    
-    currentTries.push_back(t);
-    bool win = true;
-    for (unsigned int i = 1; i < t.states.size(); ++i)
+InputResult Tomus::Input(const std::string& input)
+{
+    TOMUS_PROFILE_SCOPE("Tomus::Input");
+    Pattern pattern = 0;
+    const InputResult r = Play(input, pattern);
+    TOMUS_PROFILE_COUNT("tries", currentTries.size());
+    if (log)
     {
-        if (t.states[i] != State::GOOD_POSITION) 
-            win = false;
+        // Inputs that can not be packed are refused without side effect,
+        // they are logged with an empty word
+        uint64_t code = 0;
+        const bool packed = input.size() < kMaxPackedLength && PackWord(input, code);
+        const uint64_t value = packed ? PackedWord(code, input.size()).bits : 0;
+        log->Write({0, GameEventType::INPUT, (uint8_t)r, pattern, value});
     }
+    return r;
+}
 
-    if (win)
+InputResult Tomus::Play(const std::string& input, Pattern& pattern)
+{
+    const auto& lastTry = currentTries.back();
+
+    uint64_t guess;
+    const InputResult r = ScoreInput(config, lastTry.word.Code(), lastTry.word.size(), input, guess, pattern);
+    if (r != InputResult::VALID && r != InputResult::WIN)
+        return r;
+
+    // Past maxTries the game is lost, the board does not grow any further
+    if (currentTries.size() > config.maxTries)
+        return InputResult::LOSE;
+
+    currentTries.push_back(lastTry);
+    currentTries.back().Apply(guess, pattern);
+
+    if (r == InputResult::WIN)
         return InputResult::WIN;
 
     if (currentTries.size() > config.maxTries)
@@ -135,7 +205,21 @@ const std::vector<Try>& Tomus::Tries() const
     return currentTries;
 }
 
-const std::vector<std::vector<Try>>& Tomus::History() const
+void TryHistory::Append(std::span<const Try> tries)
+{
+    if (used + tries.size() > kChunkSize)
+    {
+        chunks.push_back(std::make_unique<Try[]>(std::max(kChunkSize, tries.size())));
+        used = 0;
+    }
+
+    Try* dst = chunks.back().get() + used;
+    std::copy(tries.begin(), tries.end(), dst);
+    entries.emplace_back(dst, tries.size());
+    used += tries.size();
+}
+
+const TryHistory& Tomus::History() const
 {
     return history;
 }
@@ -1,12 +1,14 @@
+#pragma once
+
 #include "config.h"
+#include "feedback.h"
+#include "gamelog.h"
+#include "random.h"
 
-enum class State 
-{
-    GOOD_POSITION = 0,
-    IN_WORD = 1,
-    NOT_IN_WORD = 2,
-    UNKNOWN = 3
-};
+#include <memory>
+#include <span>
+
+struct WordSampler;
 
 enum class InputResult
 {
@@ -18,37 +20,175 @@ enum class InputResult
     LOSE = 5
 };
 
+// Points awarded for a word found in the given number of guesses
+uint32_t computeScore(uint32_t guess);
+
+// Check input against the game rules for a packed answer of the given length
+// and score it. Returns VALID or WIN with guess and pattern filled, or why the
+// input is refused. Losing depends on the number of tries and is left to the
+// caller.
+InputResult ScoreInput(const Config& config, uint64_t answer, uint32_t length, std::string_view input, uint64_t& guess, Pattern& pattern);
+
+// Packed word (see word.h) of up to 11 letters with its length in the top
+// bits, readable like a string. The initial try's input only knows its first
+// letter, the others read as '.'.
+struct PackedWord
+{
+    PackedWord()
+    {}
+
+    PackedWord(uint64_t code, uint32_t length, bool firstOnly = false) : 
+        bits(code | (uint64_t(length) << 56) | (uint64_t(firstOnly) << 63))
+    { }
+
+    char operator[](std::size_t i) const
+    {
+        if (i > 0 && (bits >> 63)) return '.';
+        return UnpackLetter(Code(), size(), i);
+    }
+
+    std::size_t size() const
+    {
+        return (bits >> 56) & 0xF;
+    }
+
+    uint64_t Code() const
+    {
+        return bits & ((uint64_t(1) << 56) - 1);
+    }
+
+    std::string ToString() const
+    {
+        std::string str(size(), '.');
+        for (std::size_t i = 0; i < str.size(); ++i)
+            str[i] = (*this)[i];
+        return str;
+    }
+
+    uint64_t bits = 0;
+};
+
+// Up to 32 states of 2 bits, readable like an array
+struct PackedStates
+{
+    State operator[](std::size_t i) const
+    {
+        return (State)((bits >> (2 * i)) & 0x3);
+    }
+
+    void Set(std::size_t i, State s)
+    {
+        bits = (bits & ~(uint64_t(0x3) << (2 * i))) | (uint64_t(s) << (2 * i));
+    }
+
+    bool operator==(const PackedStates& other) const = default;
+
+    uint64_t bits = ~uint64_t(0); // All UNKNOWN
+};
+
+// One line of the board, a few machine words and no allocation: the answer and
+// input as packed words, per position states and per letter states
 struct Try
 {
-    Try(std::string_view word);
+    Try()
+    {}
+
+    Try(std::string_view word, uint32_t wordIndex = 0);
+
+    // Record a packed input and its feedback, updating best known states and letters
+    void Apply(uint64_t input, Pattern pattern);
 
-    std::string word;
-    std::string input;
+    // Feedback of input, as recorded in states
+    Pattern Feedback() const;
 
-    std::vector<State> states;
-    std::vector<State> bestStates;
-    std::array<State, 26> letters;
+    PackedWord word;
+    PackedWord input;
+
+    PackedStates states;
+    PackedStates bestStates;
+    PackedStates letters;
+
+    uint32_t wordIndex = 0; // In Config::words
+};
+
+// Append-only storage for the tries of past words. Tries live in large chunks
+// that never move, each word's tries being contiguous, so appending a word
+// does not copy the previous ones and rarely allocates.
+struct TryHistory
+{
+    struct Iterator
+    {
+        std::span<const Try> operator*() const { return (*history)[index]; }
+        Iterator& operator++() { ++index; return *this; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+        const TryHistory* history;
+        std::size_t index;
+    };
+
+    void Append(std::span<const Try> tries);
+
+    std::span<const Try> operator[](std::size_t i) const
+    {
+        return entries[i];
+    }
+
+    std::size_t size() const
+    {
+        return entries.size();
+    }
+
+    Iterator begin() const { return {this, 0}; }
+    Iterator end() const { return {this, entries.size()}; }
+private:
+    static constexpr std::size_t kChunkSize = 1024;
+
+    std::vector<std::unique_ptr<Try[]>> chunks;
+    std::size_t used = kChunkSize;
+    std::vector<std::span<const Try>> entries;
 };
 
 struct Tomus
 {
 public:
-    Tomus(const Config& c) : config(c), gen(std::random_device{}())
-    { }
+    Tomus(const Config& c) : Tomus(c, c.seed ? *c.seed : std::random_device{}())
+    {}
+    Tomus(const Config& c, uint64_t s) : config(c), seed(s), gen(s)
+    {
+        currentTries.reserve(config.maxTries + 1);
+    }
+
+    // Every NewWord and Input is appended to the log, which must outlive the game
+    void SetLog(GameLogWriter* log);
+    uint64_t Seed() const;
+
+    // Random words are drawn from the sampler instead of uniformly, it must
+    // outlive the game
+    void SetSampler(const WordSampler* sampler);
 
     void NewWord();
+    void NewWord(std::size_t index);
+
+    // Replace the current word by another of the same length and first
+    // letter giving the same feedback to the tries played (see AbsurdGame)
+    void SwapWord(std::size_t index);
 
     InputResult Input(const std::string& input);
 
     const std::vector<Try>& Tries() const;
-    const std::vector<std::vector<Try>>& History() const;
+    const TryHistory& History() const;
     unsigned int Score() const;
     const Config& config;
 private:
+    void Start(std::size_t index);
+    InputResult Play(const std::string& input, Pattern& pattern);
+
     unsigned int score = 0;
-    std::vector<Try> currentTries;   
-    std::vector<std::vector<Try>> history;
+    std::vector<Try> currentTries; // Reserved once, never reallocated
+    TryHistory history;
 
-    std::mt19937 gen;
+    uint64_t seed;
+    Rng gen;
+    GameLogWriter* log = nullptr;
+    const WordSampler* sampler = nullptr;
 };
-
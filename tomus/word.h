@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+#include <cstdint>
+
+// Words are packed 5 bits per letter, first letter in the most significant
+// position, so that sorting packed codes of the same length sorts the words
+// lexicographically.
+constexpr uint32_t kMaxPackedLength = 12;
+constexpr uint32_t kLetterBits = 5;
+
+inline bool PackWord(std::string_view word, uint64_t& code)
+{
+    if (word.size() == 0 || word.size() > kMaxPackedLength)
+        return false;
+
+    code = 0;
+    for (const char c : word)
+    {
+        if (c < 'a' || c > 'z')
+            return false;
+        code = (code << kLetterBits) | (uint64_t)(c - 'a');
+    }
+    return true;
+}
+
+inline char UnpackLetter(uint64_t code, uint32_t length, uint32_t i)
+{
+    const uint32_t shift = kLetterBits * (length - 1 - i);
+    return (char)('a' + ((code >> shift) & 0x1F));
+}
+
+inline std::string UnpackWord(uint64_t code, uint32_t length)
+{
+    std::string word(length, ' ');
+    for (uint32_t i = 0; i < length; ++i)
+        word[i] = UnpackLetter(code, length, i);
+    return word;
+}
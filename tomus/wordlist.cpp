@@ -0,0 +1,47 @@
+#include "wordlist.h"
+
+struct OwnedWordList
+{
+    std::vector<char> chars;
+    std::vector<uint32_t> offsets;
+};
+
+WordList::WordList(std::shared_ptr<const void> owner, const char* c, const uint32_t* o, std::size_t n) :
+    storage(std::move(owner)), chars(c), offsets(o), count(n)
+{ }
+
+uint64_t WordList::Hash() const
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        for (const char c : (*this)[i])
+        {
+            h ^= (uint8_t)c;
+            h *= 0x100000001b3ull;
+        }
+        h ^= '\n';
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+void WordList::Append(const std::vector<std::string>& words)
+{
+    auto owned = std::make_shared<OwnedWordList>();
+    owned->chars.assign(chars, chars + (count > 0 ? offsets[count] : 0));
+    owned->offsets.assign(offsets, offsets + (count > 0 ? count + 1 : 0));
+    if (owned->offsets.empty())
+        owned->offsets.push_back(0);
+
+    for (const auto& w : words)
+    {
+        owned->chars.insert(owned->chars.end(), w.begin(), w.end());
+        owned->offsets.push_back(owned->chars.size());
+    }
+
+    chars = owned->chars.data();
+    offsets = owned->offsets.data();
+    count = owned->offsets.size() - 1;
+    storage = std::move(owned);
+}
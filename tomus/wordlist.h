@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+
+// Immutable list of words stored as a single character blob and an offset
+// table, either owned or pointing into a mapped dictionary image. Copies share
+// the same underlying storage.
+struct WordList
+{
+    WordList()
+    {}
+
+    WordList(std::shared_ptr<const void> owner, const char* chars, const uint32_t* offsets, std::size_t count);
+
+    void Append(const std::vector<std::string>& words);
+
+    std::string_view operator[](std::size_t i) const
+    {
+        return std::string_view(chars + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    const char* Chars() const
+    {
+        return chars;
+    }
+
+    const uint32_t* Offsets() const
+    {
+        return offsets;
+    }
+
+    // FNV-1a over the words, one per line, to tell files built from another
+    // list
+    uint64_t Hash() const;
+private:
+    std::shared_ptr<const void> storage;
+    const char* chars = nullptr;
+    const uint32_t* offsets = nullptr;
+    std::size_t count = 0;
+};
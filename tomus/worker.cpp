@@ -0,0 +1,85 @@
+#include <exception>
+
+#include "worker.h"
+
+IoWorker::IoWorker() : thread([this]() { Run(); })
+{}
+
+IoWorker::~IoWorker()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void IoWorker::Post(std::function<void()> job, std::function<void(const std::string& error)> done)
+{
+    {
+        std::lock_guard lock(mutex);
+        jobs.push_back([job = std::move(job), done = std::move(done), this]() {
+            std::string error;
+            try
+            {
+                job();
+            }
+            catch (const std::exception& ex)
+            {
+                error = std::string("Error, background job failed: ") + ex.what();
+            }
+            catch (...)
+            {
+                error = "Error, background job failed";
+            }
+
+            if (done)
+            {
+                std::lock_guard lock(mutex);
+                completions.push_back([done = std::move(done), error = std::move(error)]() { done(error); });
+            }
+        });
+    }
+    wake.notify_one();
+}
+
+std::size_t IoWorker::Poll()
+{
+    std::deque<std::function<void()>> ready;
+    {
+        std::lock_guard lock(mutex);
+        ready.swap(completions);
+    }
+    for (auto& done : ready)
+        done();
+    return ready.size();
+}
+
+std::size_t IoWorker::Pending() const
+{
+    std::lock_guard lock(mutex);
+    return jobs.size() + running;
+}
+
+void IoWorker::Run()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            running++;
+        }
+        job();
+
+        std::lock_guard lock(mutex);
+        running--;
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Background thread running jobs in submission order, for the slow I/O
+// (loading the dictionaries, syncing the leaderboard) the game loop must not
+// wait on. Completions are queued back and run by Poll on the caller's
+// thread, so they can touch game state without locking.
+//
+// The destructor runs the jobs still queued before joining: saves submitted
+// just before quitting are not lost. Their completions are dropped.
+//
+// A job throwing does not take the worker down: the exception is caught and
+// its completion gets the error message instead, empty when the job ran.
+struct IoWorker
+{
+    IoWorker();
+    ~IoWorker();
+
+    IoWorker(const IoWorker&) = delete;
+    IoWorker& operator=(const IoWorker&) = delete;
+
+    void Post(std::function<void()> job, std::function<void(const std::string& error)> done = {});
+
+    // job() runs on the worker, done(result, error) later on the thread
+    // calling Poll. The result is value initialised when the job threw.
+    template<typename T>
+    void Submit(std::function<T()> job, std::function<void(T, const std::string& error)> done)
+    {
+        auto result = std::make_shared<T>();
+        Post([result, job = std::move(job)]() { *result = job(); },
+             [result, done = std::move(done)](const std::string& error) { done(std::move(*result), error); });
+    }
+
+    // Runs the completions of finished jobs, returns how many ran
+    std::size_t Poll();
+
+    // Jobs queued or running
+    std::size_t Pending() const;
+private:
+    void Run();
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> jobs;
+    std::deque<std::function<void()>> completions;
+    std::size_t running = 0;
+    bool stopping = false;
+    std::thread thread;
+};
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+
+#include "tomus/archive.h"
+#include "tomus/parallel.h"
+#include "tomus/tomus.h"
+
+// Analytics over the archived runs of the former leaderboard.json, streamed
+// chunk by chunk (see archive.h): memory stays around chunk size x workers
+// plus the statistics, whatever the size of the archive.
+//
+// Usage: tomus_analytics stats <archive> [--top N] [--min-plays N] [--chunk MiB]
+//        tomus_analytics convert <leaderboard.json> <out.col> [--chunk MiB]
+//
+// stats reads either the json archive or its columnar copy (written by
+// convert), which is much faster to query again.
+
+static PackedWord Word(uint64_t bits)
+{
+    PackedWord word;
+    word.bits = bits;
+    return word;
+}
+
+// Games are the words found, the answer is the last guess and the first one
+// the opening
+struct ArchiveStats
+{
+    void AddEntry(int32_t entryScore)
+    {
+        entries++;
+        score += entryScore;
+    }
+
+    void AddGame(std::span<const uint64_t> game)
+    {
+        if (game.empty())
+            return;
+        games++;
+        openings[game.front()]++;
+
+        auto& [plays, tries] = answers[game.back()];
+        plays++;
+        tries += game.size();
+
+        const uint32_t letter = Word(game.back())[0] - 'a';
+        if (letter < 26)
+        {
+            letterGames[letter]++;
+            letterTries[letter] += game.size();
+        }
+    }
+
+    void Merge(const ArchiveStats& other)
+    {
+        entries += other.entries;
+        games += other.games;
+        score += other.score;
+        for (const auto& [word, count] : other.openings)
+            openings[word] += count;
+        for (const auto& [word, played] : other.answers)
+        {
+            answers[word].first += played.first;
+            answers[word].second += played.second;
+        }
+        for (uint32_t l = 0; l < 26; ++l)
+        {
+            letterGames[l] += other.letterGames[l];
+            letterTries[l] += other.letterTries[l];
+        }
+    }
+
+    uint64_t entries = 0;
+    uint64_t games = 0;
+    int64_t score = 0;
+    std::unordered_map<uint64_t, uint64_t> openings;                    // PackedWord bits -> games
+    std::unordered_map<uint64_t, std::pair<uint64_t, uint64_t>> answers; // PackedWord bits -> games, tries
+    uint64_t letterGames[26] = {};
+    uint64_t letterTries[26] = {};
+};
+
+static void Print(const ArchiveStats& stats, std::size_t top, uint64_t minPlays)
+{
+    std::cout << stats.entries << " entries, " << stats.games << " games, mean score "
+              << (stats.entries ? stats.score / double(stats.entries) : 0.) << std::endl;
+
+    // Most common openings, per word length
+    std::map<std::size_t, std::vector<std::pair<uint64_t, uint64_t>>> byLength;
+    for (const auto& [word, count] : stats.openings)
+        byLength[Word(word).size()].push_back({count, word});
+    for (auto& [length, openings] : byLength)
+    {
+        const std::size_t n = std::min(top, openings.size());
+        std::partial_sort(openings.begin(), openings.begin() + n, openings.end(), std::greater<>());
+        std::cout << std::endl << "Openings, " << length << " letters:" << std::endl;
+        for (std::size_t i = 0; i < n; ++i)
+            std::cout << "  " << Word(openings[i].second).ToString() << "  " << openings[i].first << std::endl;
+    }
+
+    std::cout << std::endl << "Mean tries per first letter:" << std::endl << std::fixed << std::setprecision(3);
+    for (uint32_t l = 0; l < 26; ++l)
+        if (stats.letterGames[l])
+            std::cout << "  " << char('a' + l) << "  " << stats.letterTries[l] / double(stats.letterGames[l])
+                      << "  (" << stats.letterGames[l] << " games)" << std::endl;
+
+    std::vector<std::pair<double, uint64_t>> hardest;
+    for (const auto& [word, played] : stats.answers)
+        if (played.first >= minPlays)
+            hardest.push_back({played.second / double(played.first), word});
+    const std::size_t n = std::min(top, hardest.size());
+    std::partial_sort(hardest.begin(), hardest.begin() + n, hardest.end(), std::greater<>());
+    std::cout << std::endl << "Hardest answers (" << minPlays << "+ games):" << std::endl;
+    for (std::size_t i = 0; i < n; ++i)
+        std::cout << "  " << Word(hardest[i].second).ToString() << "  " << hardest[i].first
+                  << "  (" << stats.answers.at(hardest[i].second).first << " games)" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args;
+    std::size_t top = 10, chunkSize = kArchiveChunkSize;
+    uint64_t minPlays = 3;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--top") == 0 && i + 1 < argc)
+            top = std::stoul(argv[++i]);
+        else if (std::strcmp(argv[i], "--min-plays") == 0 && i + 1 < argc)
+            minPlays = std::stoull(argv[++i]);
+        else if (std::strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+            chunkSize = std::stoul(argv[++i]) << 20;
+        else
+            args.push_back(argv[i]);
+    }
+
+    if (!((args.size() == 2 && args[0] == "stats") || (args.size() == 3 && args[0] == "convert")))
+    {
+        std::cerr << "Usage: tomus_analytics stats <archive> [--top N] [--min-plays N] [--chunk MiB]" << std::endl;
+        std::cerr << "       tomus_analytics convert <leaderboard.json> <out.col> [--chunk MiB]" << std::endl;
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::string error;
+
+    if (args[0] == "convert")
+    {
+        ColumnarWriter writer;
+        if (!writer.Open(args[2]))
+        {
+            std::cerr << "Error, can not write: " << args[2] << std::endl;
+            return 1;
+        }
+
+        std::atomic<uint64_t> entries = 0;
+        const bool scanned = ScanJsonArchive(args[1], [&](std::span<const LeaderboardEntry> batch, std::size_t chunk, unsigned int) {
+            writer.Append(chunk, batch);
+            entries += batch.size();
+        }, error, chunkSize);
+        if (!scanned)
+        {
+            std::cerr << "Error, " << error << std::endl;
+            return 1;
+        }
+        if (!writer.Close())
+        {
+            std::cerr << "Error, can not write: " << args[2] << std::endl;
+            return 1;
+        }
+
+        std::cout << entries << " entries converted in "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+        return 0;
+    }
+
+    std::vector<ArchiveStats> workers(WorkerCount());
+    if (IsColumnarArchive(args[1]))
+    {
+        ColumnarArchive archive;
+        if (!archive.Open(args[1]))
+        {
+            std::cerr << "Error, corrupted columnar archive: " << args[1] << std::endl;
+            return 1;
+        }
+
+        const auto& groups = archive.Groups();
+        ParallelFor(groups.size(), [&](std::size_t g, unsigned int worker) {
+            const ColumnGroup& group = groups[g];
+            ArchiveStats& stats = workers[worker];
+            for (std::size_t e = 0; e < group.Entries(); ++e)
+            {
+                stats.AddEntry(group.score[e]);
+                const auto [begin, end] = group.Games(e);
+                for (uint32_t game = begin; game < end; ++game)
+                    stats.AddGame(group.Game(game));
+            }
+        }, 1);
+    }
+    else
+    {
+        const bool scanned = ScanJsonArchive(args[1], [&](std::span<const LeaderboardEntry> batch, std::size_t, unsigned int worker) {
+            ArchiveStats& stats = workers[worker];
+            for (const LeaderboardEntry& e : batch)
+            {
+                stats.AddEntry(e.score);
+                for (const auto& game : e.guesses)
+                    stats.AddGame(game);
+            }
+        }, error, chunkSize);
+        if (!scanned)
+        {
+            std::cerr << "Error, " << error << std::endl;
+            return 1;
+        }
+    }
+
+    ArchiveStats stats;
+    for (const ArchiveStats& w : workers)
+        stats.Merge(w);
+    Print(stats, top, minPlays);
+    std::cout << std::endl << std::defaultfloat
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+    return 0;
+}
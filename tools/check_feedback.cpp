@@ -0,0 +1,153 @@
+#include <atomic>
+
+#include "tomus/dictionary.h"
+#include "tomus/parallel.h"
+#include "tomus/tomus.h"
+
+// Exhaustively compare the feedback kernel used by Tomus::Input against the
+// original quadratic algorithm, for every solution word and every admissible
+// guess of the same length and first letter. Guesses are chained on the same
+// try like in a game, so that letters and best states are checked as well,
+// and the packed Try is compared with the original layout.
+//
+// Usage: tomus_check_feedback [config.json]
+
+// Original Try layout and Tomus::Input scoring, kept as reference
+struct ReferenceTry
+{
+    ReferenceTry(std::string_view w) : 
+        word(w), input(w.size(), '.'),
+        states(w.size(), State::UNKNOWN),
+        bestStates(w.size(), State::UNKNOWN)
+    {
+        std::fill(letters.begin(), letters.end(), State::UNKNOWN);
+
+        input[0] = w[0];
+        states[0] = State::GOOD_POSITION;
+        bestStates[0] = State::GOOD_POSITION;
+    }
+
+    std::string word;
+    std::string input;
+
+    std::vector<State> states;
+    std::vector<State> bestStates;
+    std::array<State, 26> letters;
+};
+
+ReferenceTry ReferenceInput(const ReferenceTry& lastTry, const std::string& input)
+{
+    ReferenceTry t = lastTry;
+
+    t.input = std::string{input};
+    std::fill(t.states.begin() + 1, t.states.end(), State::UNKNOWN);
+
+    for (unsigned int i = 1; i < t.word.size(); ++i)
+    {
+        const char current = input[i];
+        const int idx = current - 'a';
+        if (current == t.word[i])
+        {
+            t.states[i] = State::GOOD_POSITION;
+            t.letters[idx] = State::GOOD_POSITION;
+            t.bestStates[i] = State::GOOD_POSITION;
+        }
+    }
+    for (unsigned int i = 1; i < t.word.size(); ++i)
+    {
+        const char current = input[i];
+        const int idx = current - 'a';
+        if (current != t.word[i])
+        {
+            if (t.letters[idx] == State::NOT_IN_WORD)
+                continue;
+
+            int32_t countInWord  = 0;
+            int32_t countGoodPos = 0;
+            int32_t countLetter = 0;
+            
+            for (unsigned int j = 1; j < t.word.size(); ++j)
+            {
+                if (t.word[j] == current) countLetter++;
+
+                if (input[j] == current)
+                {
+                    if (t.states[j] == State::GOOD_POSITION)
+                        countGoodPos++;
+                    if (t.states[j] == State::IN_WORD)
+                        countInWord++;
+                }
+            }
+
+            if (countLetter == 0)
+            {
+                t.letters[idx] = State::NOT_IN_WORD;
+            }
+            else if (countLetter - countInWord - countGoodPos > 0)
+            {
+                t.states[i] = State::IN_WORD;
+
+                if (t.letters[idx] == State::UNKNOWN)
+                    t.letters[idx] = State::IN_WORD;
+
+                if (t.bestStates[i] == State::UNKNOWN)
+                    t.bestStates[i] = State::IN_WORD;
+            }
+        }
+    }
+    return t;
+}
+
+int main(int argc, char** argv)
+{
+    const std::string configPath = argc > 1 ? argv[1] : "res/config.json";
+
+    const Config conf = LoadConfig(configPath);
+
+    std::atomic<std::size_t> pairs = 0;
+    std::atomic<std::size_t> mismatches = 0;
+    ParallelFor(conf.words.size(), [&](std::size_t w, unsigned int) {
+        const std::string_view word = conf.words[w];
+        uint64_t answer;
+        if (!PackWord(word, answer))
+            return;
+
+        const auto bucket = conf.admissibleWords.Bucket(word.size());
+        const uint64_t first = answer & ~((uint64_t(1) << (kLetterBits * (word.size() - 1))) - 1);
+        const uint64_t last  = first + (uint64_t(1) << (kLetterBits * (word.size() - 1)));
+        const auto begin = std::lower_bound(bucket.begin(), bucket.end(), first);
+        const auto end   = std::lower_bound(bucket.begin(), bucket.end(), last);
+
+        ReferenceTry reference(word);
+        Try current(word);
+        std::string input(word.size(), ' ');
+        std::size_t count = 0, wrong = 0;
+        for (auto it = begin; it != end; ++it)
+        {
+            for (uint32_t i = 0; i < word.size(); ++i)
+                input[i] = UnpackLetter(*it, word.size(), i);
+
+            reference = ReferenceInput(reference, input);
+            current.Apply(*it, ComputeFeedback(*it, answer, word.size()));
+
+            bool same = (current.input.ToString() == reference.input);
+            for (uint32_t i = 0; i < word.size(); ++i)
+                same = same && reference.states[i] == current.states[i] && reference.bestStates[i] == current.bestStates[i];
+            for (uint32_t c = 0; c < 26; ++c)
+                same = same && reference.letters[c] == current.letters[c];
+
+            count++;
+            if (!same)
+            {
+                if (wrong++ == 0)
+                    std::cerr << "Mismatch: answer " << word << ", guess " << input << std::endl;
+            }
+        }
+        pairs += count;
+        mismatches += wrong;
+    });
+
+    std::cout << "Checked " << pairs << " (guess, answer) pairs over " << conf.words.size()
+              << " words: " << mismatches << " mismatches" << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+#include <chrono>
+#include <cstring>
+
+#include "tomus/decision.h"
+
+// Precompute the decision trees of every word length of a config, saved as
+// <outDir>/tree_<length>.bin for the end screen reviews. The pattern
+// matrices are loaded from (or built into) the same directory.
+//
+// Usage: tomus_decision [config.json] [outDir] [--beam N]
+//
+// The trees are optimal by default, --beam N only searches the N best
+// splitting guesses of each node, for lists too large for that.
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args;
+    uint32_t beam = DecisionTree::kDefaultBeam;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--beam") == 0 && i + 1 < argc)
+            beam = std::stoul(argv[++i]);
+        else
+            args.push_back(argv[i]);
+    }
+    const std::string configPath = args.size() > 0 ? args[0] : "res/config.json";
+    const std::string outDir     = args.size() > 1 ? args[1] : "res";
+
+    const Config conf = LoadConfig(configPath);
+
+    for (uint32_t l = conf.minLength; l <= std::min(conf.maxLength, kMaxFeedbackLength); ++l)
+    {
+        const PatternMatrix m = PatternMatrix::LoadOrBuild(outDir + "/patterns_" + std::to_string(l) + ".bin", conf, l);
+
+        const auto start = std::chrono::steady_clock::now();
+        const DecisionTree tree = DecisionTree::Build(m, conf, beam);
+        const auto end = std::chrono::steady_clock::now();
+
+        const std::string path = outDir + "/tree_" + std::to_string(l) + ".bin";
+        if (!tree.Save(path))
+        {
+            std::cerr << "Error, can not write: " << path << std::endl;
+            return 1;
+        }
+
+        uint64_t cost = 0, answers = 0;
+        for (uint32_t letter = 0; letter < 26; ++letter)
+        {
+            cost += tree.Cost(letter);
+            answers += tree.Answers(letter);
+        }
+        std::cout << "Length " << l << ": " << answers << " answers, "
+                  << (answers ? cost / double(answers) : 0.) << " guesses on average, "
+                  << std::chrono::duration<double>(end - start).count() << " s" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <nlohmann/json.hpp>
+#include <chrono>
+
+#include "tomus/dictionary.h"
+
+// Compile the word lists referenced by a config into a binary dictionary
+// image (see tomus/dictionary.h), loaded by the game when "dictionary" is set.
+//
+// Usage: tomus_dictc [config.json] [out.dict]
+
+int main(int argc, char** argv)
+{
+    using json = nlohmann::json;
+
+    const std::string configPath = argc > 1 ? argv[1] : "res/config.json";
+    const std::string outPath    = argc > 2 ? argv[2] : "res/tomus.dict";
+
+    Config conf;
+    std::string dicPath, admPath;
+    try
+    {
+        std::ifstream file(configPath);
+        if (!file)
+        {
+            std::cerr << "Error, can not load [no file]: " << configPath << std::endl;
+            return 1;
+        }
+
+        json data = json::parse(file);
+        conf.minLength = data["minLength"].get<unsigned int>();
+        conf.maxLength = data["maxLength"].get<unsigned int>();
+        dicPath = data["mots"].get<std::string>();
+        admPath = data["admissibles"].get<std::string>();
+    }
+    catch(std::exception& ex)
+    {
+        std::cerr << "Error, can not load: " << configPath << "; error = " << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (!conf.LoadText(dicPath, admPath))
+    {
+        std::cerr << "Error, can not load dictionnary: " << dicPath << ", " << admPath << std::endl;
+        return 1;
+    }
+
+    if (!SaveDictionary(outPath, conf))
+    {
+        std::cerr << "Error, can not write: " << outPath << std::endl;
+        return 1;
+    }
+
+    // Sanity check: the image must load back
+    Config check;
+    check.minLength = conf.minLength;
+    check.maxLength = conf.maxLength;
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!LoadDictionary(outPath, check))
+    {
+        std::cerr << "Error, written image does not load: " << outPath << std::endl;
+        return 1;
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Wrote " << outPath << ": " << check.words.size() << " words, "
+              << check.admissibleWords.Size() << " admissibles, loaded in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <chrono>
+
+#include "tomus/difficulty.h"
+
+// Scores the difficulty of every solution word (solver guesses, letter
+// rarity, repeated letters) and writes the sidecar read by the game when
+// "selection" is "weighted" or "progression".
+//
+// Usage: tomus_difficulty [config.json] [out.bin]
+
+int main(int argc, char** argv)
+{
+    const std::string configPath = argc > 1 ? argv[1] : "res/config.json";
+    const Config conf = LoadConfig(configPath);
+    const std::string outPath = argc > 2 ? argv[2] : conf.difficultyPath;
+
+    const auto start = std::chrono::steady_clock::now();
+    const DifficultyTable table = DifficultyTable::Build(conf);
+    const auto end = std::chrono::steady_clock::now();
+
+    if (!table.Save(outPath))
+    {
+        std::cerr << "Error, can not write: " << outPath << std::endl;
+        return 1;
+    }
+
+    std::vector<std::size_t> guesses(conf.maxTries + 2, 0);
+    std::vector<std::size_t> quartiles(4, 0);
+    for (const WordDifficulty& d : table.Words())
+    {
+        guesses[std::min<std::size_t>(d.guesses, conf.maxTries + 1)]++;
+        quartiles[std::min(3, (int)(d.difficulty * 4))]++;
+    }
+
+    for (uint32_t g = 1; g <= conf.maxTries; ++g)
+        std::cout << g << " guesses: " << guesses[g] << std::endl;
+    std::cout << "Lost: " << guesses[conf.maxTries + 1] << std::endl;
+    std::cout << "Difficulty quartiles: " << quartiles[0] << " " << quartiles[1] << " " << quartiles[2] << " " << quartiles[3] << std::endl;
+    std::cout << table.Words().size() << " words in " << std::chrono::duration<double>(end - start).count() << " s" << std::endl;
+    return 0;
+}
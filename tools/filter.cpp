@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#include "tomus/dictionary.h"
+#include "tomus/parallel.h"
+
+// Word list preprocessing, replaces filter.py: strips French accents, keeps
+// the words the game can play (lowercase a-z after stripping, within the
+// length bounds) and writes them deduplicated and sorted, so rebuilding from
+// the same sources always gives the same files. Input is read in large
+// chunks, each spread over all cores.
+//
+// Usage: tomus_filter <in> <out.txt> [--min 5] [--max 10]
+//                     [--admissible <in> <out.txt>] [--dict <out.dict>]
+//
+// --dict also writes the binary dictionary (see tomus_dictc) for a config
+// with the same bounds, from the filtered lists, without reading them back.
+
+constexpr std::size_t kChunkSize = 32 << 20;
+constexpr std::size_t kBlockSize = 256 << 10;
+
+// Words are keyed by their letters + 1, 5 bits each, left aligned: keys of
+// different lengths sort like the words
+static uint64_t Key(const char* word, uint32_t length)
+{
+    uint64_t key = 0;
+    for (uint32_t i = 0; i < kMaxPackedLength; ++i)
+        key = (key << kLetterBits) | (i < length ? (uint64_t)(word[i] - 'a' + 1) : 0);
+    return key;
+}
+
+static std::string Word(uint64_t key)
+{
+    std::string word;
+    for (int i = kMaxPackedLength - 1; i >= 0; --i)
+    {
+        const uint64_t c = (key >> (kLetterBits * i)) & 0x1F;
+        if (c == 0)
+            break;
+        word.push_back((char)('a' + c - 1));
+    }
+    return word;
+}
+
+// Base letters of U+00E0..U+00FF, '\0' for letters that do not strip to a-z
+static const char kLatin1Lower[33] = "aaaaaa\0ceeeeiiii\0nooooo\0\0uuuuy\0y";
+
+// Accents are dropped (precomposed or NFD combining marks), the ligatures
+// expand. Uppercase letters (proper nouns) and other symbols reject the word.
+static bool Normalize(std::string_view line, char* out, uint32_t& length)
+{
+    length = 0;
+    const auto push = [&](char c) {
+        if (length >= kMaxPackedLength)
+            return false;
+        out[length++] = c;
+        return true;
+    };
+
+    for (std::size_t i = 0; i < line.size(); ++i)
+    {
+        const uint8_t b = line[i];
+        if (b >= 'a' && b <= 'z')
+        {
+            if (!push(b))
+                return false;
+            continue;
+        }
+        if (b < 0xC0 || b >= 0xE0 || i + 1 >= line.size())
+            return false; // ASCII other than a-z, or not a 2 bytes sequence
+
+        const uint32_t cp = ((b & 0x1F) << 6) | (line[++i] & 0x3F);
+        if (cp >= 0x300 && cp <= 0x36F)
+            continue; // Combining mark
+
+        bool ok = false;
+        if (cp == 0xE6)       ok = push('a') && push('e');
+        else if (cp == 0x153) ok = push('o') && push('e');
+        else if (cp >= 0xE0 && cp <= 0xFF && kLatin1Lower[cp - 0xE0] != '\0')
+            ok = push(kLatin1Lower[cp - 0xE0]);
+        if (!ok)
+            return false;
+    }
+    return length > 0;
+}
+
+// Open addressing set of non zero keys, one per worker
+struct KeySet
+{
+    void Insert(uint64_t key)
+    {
+        if ((size + 1) * 2 > slots.size())
+            Grow();
+
+        std::size_t i = Hash(key) & (slots.size() - 1);
+        while (slots[i] != 0 && slots[i] != key)
+            i = (i + 1) & (slots.size() - 1);
+        if (slots[i] == 0)
+        {
+            slots[i] = key;
+            size++;
+        }
+    }
+
+    template<typename F>
+    void ForEach(F&& f) const
+    {
+        for (const uint64_t key : slots)
+            if (key != 0)
+                f(key);
+    }
+private:
+    static uint64_t Hash(uint64_t key)
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        return key;
+    }
+
+    void Grow()
+    {
+        std::vector<uint64_t> old = std::move(slots);
+        slots.assign(std::max<std::size_t>(1024, old.size() * 2), 0);
+        size = 0;
+        for (const uint64_t key : old)
+            if (key != 0)
+                Insert(key);
+    }
+
+    std::vector<uint64_t> slots;
+    std::size_t size = 0;
+};
+
+struct Filtered
+{
+    std::vector<std::string> words;
+    std::size_t lines = 0;
+    std::size_t bytes = 0;
+};
+
+static bool FilterFile(const std::string& path, uint32_t minLength, uint32_t maxLength, Filtered& result)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::vector<KeySet> sets(WorkerCount());
+    std::vector<std::size_t> lines(WorkerCount(), 0);
+
+    std::vector<char> chunk;
+    std::size_t carry = 0;
+    while (true)
+    {
+        chunk.resize(carry + kChunkSize);
+        file.read(chunk.data() + carry, kChunkSize);
+        const std::size_t size = carry + file.gcount();
+        const bool last = file.gcount() < (std::streamsize)kChunkSize;
+        result.bytes += file.gcount();
+
+        // Whole lines only, the rest goes with the next chunk
+        std::size_t end = size;
+        if (!last)
+        {
+            while (end > 0 && chunk[end - 1] != '\n')
+                --end;
+            if (end == 0)
+                end = size; // A single line larger than a chunk
+        }
+
+        // Blocks of whole lines, one per job
+        std::vector<std::pair<std::size_t, std::size_t>> blocks;
+        for (std::size_t b = 0; b < end;)
+        {
+            std::size_t e = std::min(end, b + kBlockSize);
+            while (e < end && chunk[e - 1] != '\n')
+                ++e;
+            blocks.emplace_back(b, e);
+            b = e;
+        }
+
+        ParallelFor(blocks.size(), [&](std::size_t i, unsigned int worker) {
+            const char* p = chunk.data() + blocks[i].first;
+            const char* stop = chunk.data() + blocks[i].second;
+            char word[kMaxPackedLength];
+            while (p < stop)
+            {
+                const char* eol = static_cast<const char*>(std::memchr(p, '\n', stop - p));
+                if (!eol)
+                    eol = stop;
+                std::string_view line(p, eol - p);
+                if (!line.empty() && line.back() == '\r')
+                    line.remove_suffix(1);
+                p = eol + 1;
+
+                lines[worker]++;
+                uint32_t length;
+                if (Normalize(line, word, length) && length >= minLength && length <= maxLength)
+                    sets[worker].Insert(Key(word, length));
+            }
+        }, 1);
+
+        if (last)
+            break;
+        std::memmove(chunk.data(), chunk.data() + end, size - end);
+        carry = size - end;
+    }
+
+    // Merging and sorting makes the output independent of the scheduling
+    std::vector<uint64_t> keys;
+    for (const KeySet& set : sets)
+        set.ForEach([&](uint64_t key) { keys.push_back(key); });
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    result.words.resize(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i)
+        result.words[i] = Word(keys[i]);
+    for (const std::size_t l : lines)
+        result.lines += l;
+    return true;
+}
+
+static bool WriteList(const std::string& path, const std::vector<std::string>& words)
+{
+    std::string out;
+    for (const std::string& w : words)
+    {
+        out += w;
+        out += '\n';
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), out.size());
+    return (bool)file;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: tomus_filter <in> <out.txt> [--min 5] [--max 10] [--admissible <in> <out.txt>] [--dict <out.dict>]" << std::endl;
+        return 1;
+    }
+
+    const std::string inPath = argv[1];
+    const std::string outPath = argv[2];
+    uint32_t minLength = 5, maxLength = 10;
+    std::string admIn, admOut, dictPath;
+    for (int i = 3; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--min" && i + 1 < argc)             minLength = std::stoul(argv[++i]);
+        else if (arg == "--max" && i + 1 < argc)        maxLength = std::stoul(argv[++i]);
+        else if (arg == "--dict" && i + 1 < argc)       dictPath = argv[++i];
+        else if (arg == "--admissible" && i + 2 < argc)
+        {
+            admIn = argv[++i];
+            admOut = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Error, unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (maxLength > kMaxPackedLength || minLength > maxLength)
+    {
+        std::cerr << "Error, lengths must be within [1, " << kMaxPackedLength << "]" << std::endl;
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    Filtered words, admissibles;
+    if (!FilterFile(inPath, minLength, maxLength, words))
+    {
+        std::cerr << "Error, can not read: " << inPath << std::endl;
+        return 1;
+    }
+    if (!admIn.empty() && !FilterFile(admIn, minLength, maxLength, admissibles))
+    {
+        std::cerr << "Error, can not read: " << admIn << std::endl;
+        return 1;
+    }
+
+    if (!WriteList(outPath, words.words) || (!admOut.empty() && !WriteList(admOut, admissibles.words)))
+    {
+        std::cerr << "Error, can not write the lists" << std::endl;
+        return 1;
+    }
+
+    if (!dictPath.empty())
+    {
+        // Same selection as Config::LoadText would make from the lists
+        Config conf;
+        conf.minLength = minLength;
+        conf.maxLength = maxLength;
+
+        std::vector<std::string> solutions;
+        for (const std::string& w : words.words)
+            if (w.size() > minLength && w.size() < maxLength)
+                solutions.push_back(w);
+        conf.SetWords(solutions);
+        conf.SetAdmissible(admissibles.words);
+
+        if (!SaveDictionary(dictPath, conf))
+        {
+            std::cerr << "Error, can not write: " << dictPath << std::endl;
+            return 1;
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << inPath << ": " << words.lines << " lines, " << words.words.size() << " words kept" << std::endl;
+    if (!admIn.empty())
+        std::cout << admIn << ": " << admissibles.lines << " lines, " << admissibles.words.size() << " words kept" << std::endl;
+    std::cout << "Done in " << seconds << " s, " << (words.bytes + admissibles.bytes) / std::max(seconds, 1e-9) / (1 << 20) << " MB/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+
+#include "tomus/leaderboard.h"
+
+// Leaderboard maintenance: queries and compaction of leaderboard.log/.idx.
+//
+// Usage: tomus_leaderboard <base> top [k] [year] [month] [day]
+//        tomus_leaderboard <base> daily <puzzle> [k]
+//        tomus_leaderboard <base> compact [--drop-guesses]
+//        tomus_leaderboard <base> import <leaderboard.json>
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: tomus_leaderboard <base> top [k] [year] [month] [day]" << std::endl;
+        std::cerr << "       tomus_leaderboard <base> daily <puzzle> [k]" << std::endl;
+        std::cerr << "       tomus_leaderboard <base> compact [--drop-guesses]" << std::endl;
+        std::cerr << "       tomus_leaderboard <base> import <leaderboard.json>" << std::endl;
+        return 1;
+    }
+
+    const std::string base = argv[1];
+    const std::string command = argv[2];
+
+    Leaderboard board;
+    if (!board.Open(base))
+    {
+        std::cerr << "Error, can not open leaderboard: " << base << ".log" << std::endl;
+        return 1;
+    }
+
+    if (command == "top" || (command == "daily" && argc > 3))
+    {
+        // Daily puzzle ids are yyyy * 1000 + day of the year, from 1
+        const bool daily = command == "daily";
+        const int kArg = daily ? 4 : 3;
+        const std::size_t k = argc > kArg ? std::stoul(argv[kArg]) : 10;
+        LeaderboardPeriod period;
+        if (daily)
+            period.puzzle = std::stoul(argv[3]);
+        else
+        {
+            if (argc > 4) period.year  = std::stoi(argv[4]);
+            if (argc > 5) period.month = std::stoi(argv[5]);
+            if (argc > 6) period.day   = std::stoi(argv[6]);
+        }
+
+        for (const LeaderboardSummary& e : board.Top(k, period))
+            std::cout << (int)e.day << "/" << (int)e.month << "/" << e.year << " - " << e.name << " - "
+                      << e.score << " en " << e.wordCount << " mots, " << e.time << " s" << std::endl;
+        std::cout << board.Size() << " entries" << std::endl;
+    }
+    else if (command == "compact")
+    {
+        const bool keepGuesses = !(argc > 3 && std::string(argv[3]) == "--drop-guesses");
+        if (!board.Compact(keepGuesses))
+        {
+            std::cerr << "Error, compaction failed" << std::endl;
+            return 1;
+        }
+        std::cout << "Compacted: " << board.Size() << " entries" << std::endl;
+    }
+    else if (command == "import" && argc > 3)
+    {
+        if (!board.ImportJson(argv[3]))
+        {
+            std::cerr << "Error, can not import: " << argv[3] << std::endl;
+            return 1;
+        }
+        std::cout << "Imported, " << board.Size() << " entries" << std::endl;
+    }
+    else
+    {
+        std::cerr << "Error, unknown command: " << command << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include <chrono>
+
+#include "tomus/patterns.h"
+
+// Precompute the guess x answer feedback matrices of every word length of a
+// config, saved as <outDir>/patterns_<length>.bin. Up to date matrices are
+// reused as is.
+//
+// Usage: tomus_patterns [config.json] [outDir]
+
+int main(int argc, char** argv)
+{
+    const std::string configPath = argc > 1 ? argv[1] : "res/config.json";
+    const std::string outDir     = argc > 2 ? argv[2] : "res";
+
+    const Config conf = LoadConfig(configPath);
+
+    for (uint32_t l = conf.minLength; l <= std::min(conf.maxLength, kMaxFeedbackLength); ++l)
+    {
+        const std::string path = outDir + "/patterns_" + std::to_string(l) + ".bin";
+
+        const auto start = std::chrono::steady_clock::now();
+        const PatternMatrix m = PatternMatrix::LoadOrBuild(path, conf, l);
+        const auto end = std::chrono::steady_clock::now();
+
+        std::cout << "Length " << l << ": " << m.Guesses().size() << " guesses x " << m.Answers().size()
+                  << " answers, " << m.MemoryUsage() / 1024 << " KiB, "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+
+#include "tomus/difficulty.h"
+#include "tomus/parallel.h"
+#include "tomus/tomus.h"
+
+// Replays game logs (see gamelog.h) through the engine and checks that the
+// seeded word draws and every input result come out the same.
+//
+// Usage: tomus_replay [config.json] <log or directory of logs>...
+
+struct Replay
+{
+    std::size_t events = 0;
+    std::size_t mismatches = 0;
+    std::string error;
+};
+
+static Replay ReplayLog(const Config& conf, const WordSampler* sampler, const std::string& path)
+{
+    Replay r;
+    GameLogHeader header;
+    std::vector<GameEvent> events;
+    if (!ReadGameLog(path, header, events))
+    {
+        r.error = "not a game log";
+        return r;
+    }
+    if (header.wordCount != conf.words.size() || header.minLength != conf.minLength
+        || header.maxLength != conf.maxLength || header.maxTries != conf.maxTries)
+    {
+        r.error = "recorded with another configuration";
+        return r;
+    }
+
+    Tomus tomus(conf, header.seed);
+    if (sampler)
+        tomus.SetSampler(sampler);
+    bool started = false;
+    for (const GameEvent& e : events)
+    {
+        r.events++;
+        if (e.type == GameEventType::NEW_WORD)
+        {
+            if (e.value >= conf.words.size())
+            {
+                r.mismatches++;
+                continue;
+            }
+
+            // Random draws must reproduce the logged word, they then keep
+            // the generator in step for the next ones
+            if (e.result)
+            {
+                tomus.NewWord();
+                if (tomus.Tries()[0].wordIndex != e.value)
+                    r.mismatches++;
+            }
+            else
+            {
+                tomus.NewWord(e.value);
+            }
+            started = true;
+        }
+        else if (e.type == GameEventType::SWAP_WORD)
+        {
+            if (!started || e.value >= conf.words.size())
+                r.mismatches++;
+            else
+                tomus.SwapWord(e.value);
+        }
+        else if (started && e.value != 0)
+        {
+            PackedWord input;
+            input.bits = e.value;
+            if (tomus.Input(input.ToString()) != (InputResult)e.result)
+                r.mismatches++;
+        }
+    }
+    return r;
+}
+
+int main(int argc, char** argv)
+{
+    int first = 1;
+    std::string configPath = "res/config.json";
+    if (argc > 2 && std::filesystem::path(argv[1]).extension() == ".json")
+        configPath = argv[first++];
+
+    std::vector<std::string> paths;
+    for (int i = first; i < argc; ++i)
+    {
+        if (std::filesystem::is_directory(argv[i]))
+        {
+            for (const auto& entry : std::filesystem::directory_iterator(argv[i]))
+                if (entry.is_regular_file())
+                    paths.push_back(entry.path().string());
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty())
+    {
+        std::cerr << "Usage: tomus_replay [config.json] <log or directory>..." << std::endl;
+        return 1;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    const Config conf = LoadConfig(configPath);
+
+    // Logs must be replayed with the word selection they were played with
+    WordSampler weighted;
+    const WordSampler* sampler = nullptr;
+    if (conf.selection != WordSelection::UNIFORM)
+    {
+        weighted = WordSampler(DifficultyTable::LoadOrBuild(conf.difficultyPath, conf), conf);
+        sampler = &weighted;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Replay> replays(paths.size());
+    ParallelFor(paths.size(), [&](std::size_t i, unsigned int) {
+        replays[i] = ReplayLog(conf, sampler, paths[i]);
+    });
+    const auto end = std::chrono::steady_clock::now();
+
+    std::size_t events = 0, mismatches = 0, failed = 0;
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+        const Replay& r = replays[i];
+        events += r.events;
+        mismatches += r.mismatches;
+        if (!r.error.empty())
+        {
+            std::cerr << paths[i] << ": " << r.error << std::endl;
+            failed++;
+        }
+        else if (r.mismatches > 0)
+        {
+            std::cerr << paths[i] << ": " << r.mismatches << " mismatches" << std::endl;
+            failed++;
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "Replayed " << paths.size() << " logs, " << events << " events in " << seconds << " s ("
+              << events / std::max(seconds, 1e-9) << " events/s)" << std::endl;
+    std::cout << "Mismatches: " << mismatches << ", failed logs: " << failed << std::endl;
+    return failed == 0 ? 0 : 1;
+}
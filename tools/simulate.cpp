@@ -0,0 +1,101 @@
+#include <chrono>
+#include <map>
+
+#include "tomus/parallel.h"
+#include "tomus/strategy.h"
+
+// Headless simulator: plays every solution word of a config with a strategy,
+// spreading words over all cores, and reports how the rules score it.
+//
+// Usage: tomus_sim [config.json] [random|greedy|entropy] [seed]
+
+struct Result
+{
+    uint32_t length = 0;
+    uint32_t guesses = 0;
+    bool win = false;
+};
+
+int main(int argc, char** argv)
+{
+    const std::string configPath = argc > 1 ? argv[1] : "res/config.json";
+    const std::string strategy   = argc > 2 ? argv[2] : "entropy";
+    const uint64_t seed          = argc > 3 ? std::stoull(argv[3]) : 0;
+
+    const Config conf = LoadConfig(configPath);
+
+    // Nothing is shared between workers but the immutable config
+    std::vector<std::unique_ptr<Tomus>> games;
+    std::vector<std::unique_ptr<Strategy>> strategies;
+    for (unsigned int w = 0; w < WorkerCount(); ++w)
+    {
+        games.push_back(std::make_unique<Tomus>(conf));
+        strategies.push_back(MakeStrategy(strategy, conf));
+        if (!strategies.back())
+        {
+            std::cerr << "Error, unknown strategy: " << strategy << std::endl;
+            return 1;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<Result> results(conf.words.size());
+    ParallelFor(conf.words.size(), [&](std::size_t w, unsigned int worker) {
+        Tomus& tomus = *games[worker];
+        Strategy& player = *strategies[worker];
+        Result& r = results[w];
+
+        player.Seed(seed * 0x9E3779B97F4A7C15ull + w);
+        tomus.NewWord(w);
+        r.length = conf.words[w].size();
+
+        InputResult status = InputResult::VALID;
+        while (status == InputResult::VALID)
+        {
+            const std::string guess = player.Guess(tomus.Tries());
+            if (guess.empty())
+                break;
+
+            status = tomus.Input(guess);
+            r.guesses++;
+        }
+        r.win = (status == InputResult::WIN);
+    });
+
+    const auto end = std::chrono::steady_clock::now();
+
+    // Wins by number of guesses, last bucket being losses
+    std::vector<std::size_t> distribution(conf.maxTries + 2, 0);
+    std::map<uint32_t, std::pair<std::size_t, std::size_t>> perLength; // guesses, words
+    std::size_t wins = 0, points = 0;
+    for (const Result& r : results)
+    {
+        if (r.win)
+        {
+            distribution[std::min(r.guesses, conf.maxTries)]++;
+            points += computeScore(r.guesses);
+            wins++;
+        }
+        else
+        {
+            distribution.back()++;
+        }
+        perLength[r.length].first += r.guesses;
+        perLength[r.length].second++;
+    }
+
+    std::cout << "Strategy " << strategy << ": " << results.size() << " words in "
+              << std::chrono::duration<double>(end - start).count() << " s" << std::endl;
+    std::cout << "Win rate: " << 100.0 * wins / std::max<std::size_t>(results.size(), 1) << " %" << std::endl;
+    for (uint32_t g = 1; g <= conf.maxTries; ++g)
+        std::cout << "  " << g << " guesses: " << distribution[g] << std::endl;
+    std::cout << "  lost     : " << distribution.back() << std::endl;
+
+    std::cout << "Guesses per word:" << std::endl;
+    for (const auto& [length, stats] : perLength)
+        std::cout << "  " << length << " letters: " << (double)stats.first / stats.second << std::endl;
+
+    std::cout << "Points: " << points << " (" << (double)points / std::max<std::size_t>(results.size(), 1) << " per word)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <mutex>
+
+#include "tomus/parallel.h"
+#include "tomus/solver.h"
+
+// Let the solver play words, printing its guesses. Plays every solution word
+// when no word is given.
+//
+// Usage: tomus_solve [config.json] [word...]
+
+struct Game
+{
+    std::vector<std::string> guesses;
+    bool win = false;
+    double maxHintMs = 0.0;
+};
+
+int main(int argc, char** argv)
+{
+    const std::string configPath = argc > 1 ? argv[1] : "res/config.json";
+
+    const Config conf = LoadConfig(configPath);
+
+    std::vector<std::size_t> targets;
+    for (int i = 2; i < argc; ++i)
+    {
+        for (std::size_t w = 0; w < conf.words.size(); ++w)
+            if (conf.words[w] == argv[i]) targets.push_back(w);
+    }
+    if (argc <= 2)
+    {
+        for (std::size_t w = 0; w < conf.words.size(); ++w)
+            targets.push_back(w);
+    }
+
+    std::vector<PatternMatrix> matrices;
+    for (uint32_t l = conf.minLength; l <= std::min(conf.maxLength, kMaxFeedbackLength); ++l)
+        matrices.push_back(PatternMatrix::LoadOrBuild("res/patterns_" + std::to_string(l) + ".bin", conf, l));
+
+    // One game and one solver per worker, games are the unit of parallelism
+    std::vector<std::unique_ptr<Tomus>> games;
+    std::vector<std::unique_ptr<Solver>> solvers;
+    for (unsigned int w = 0; w < WorkerCount(); ++w)
+    {
+        games.push_back(std::make_unique<Tomus>(conf));
+        solvers.push_back(std::make_unique<Solver>(conf, targets.size() == 1));
+        for (const auto& m : matrices)
+            solvers.back()->UseMatrix(m);
+    }
+
+    std::vector<Game> results(targets.size());
+    ParallelFor(targets.size(), [&](std::size_t t, unsigned int worker) {
+        Tomus& tomus = *games[worker];
+        Solver& solver = *solvers[worker];
+        Game& game = results[t];
+
+        tomus.NewWord(targets[t]);
+        while (true)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const std::string hint = solver.Hint(tomus.Tries());
+            const auto end = std::chrono::steady_clock::now();
+            game.maxHintMs = std::max(game.maxHintMs, std::chrono::duration<double, std::milli>(end - start).count());
+
+            if (hint.empty())
+                break;
+
+            game.guesses.push_back(hint);
+            const InputResult r = tomus.Input(hint);
+            if (r == InputResult::WIN)
+                game.win = true;
+            if (r != InputResult::VALID)
+                break;
+        }
+    }, 1);
+
+    std::size_t wins = 0, guesses = 0;
+    double maxHintMs = 0.0;
+    for (std::size_t t = 0; t < targets.size(); ++t)
+    {
+        const Game& g = results[t];
+        std::cout << conf.words[targets[t]] << (g.win ? " WIN " : " LOSE") << ":";
+        for (const auto& guess : g.guesses)
+            std::cout << " " << guess;
+        std::cout << std::endl;
+
+        wins += g.win;
+        guesses += g.win ? g.guesses.size() : 0;
+        maxHintMs = std::max(maxHintMs, g.maxHintMs);
+    }
+
+    std::cout << "Won " << wins << "/" << targets.size() << ", "
+              << (wins > 0 ? (double)guesses / wins : 0.0) << " guesses per win, slowest hint "
+              << maxHintMs << " ms" << std::endl;
+    return 0;
+}